@@ -5,20 +5,32 @@ DEFINE_double(ssd_gib, 1700, "");
 DEFINE_uint32(free_pct, 1, "pct");
 DEFINE_uint32(partition_bits, 6, "bits per partition");
 DEFINE_uint32(pp_threads, 1, "number of page provider threads");
+DEFINE_bool(prefetch, false, "Start the prefetcher thread that serves prefetch(keys) with asynchronous reads");
+DEFINE_uint32(prefetch_batch_size, 64, "Max reads the prefetcher keeps in flight");
 DEFINE_bool(worker_page_eviction, false, "");
 // -------------------------------------------------------------------------------------
 DEFINE_string(csv_path, "./log", "");
 DEFINE_bool(csv_truncate, false, "");
-DEFINE_string(ssd_path, "./leanstore", "Position of SSD, gets persisted");
+DEFINE_string(ssd_path, "./leanstore", "Position of SSD, gets persisted. A comma separated list stripes the pages over several SSDs");
 DEFINE_uint32(write_buffer_size, 1024, "");
 DEFINE_bool(trunc, false, "Truncate file");
 DEFINE_uint32(falloc, 0, "Preallocate GiB");
+DEFINE_uint32(ssd_grow_gib, 0, "Preallocate the data file in chunks of this many GiB ahead of the highest page, 0 = off");
+DEFINE_uint32(ssd_trim_batch, 0, "Punch holes for the oldest freed pages in batches of this many per partition, 0 = off");
+DEFINE_bool(ssd_emulated, false, "Put an emulated device with the latencies below in front of each SSD, for reproducible I/O benchmarks");
+DEFINE_double(ssd_emu_dram_gib, 0, "Keep the data of each emulated SSD in this much DRAM instead of the files, 0 = files");
+DEFINE_uint32(ssd_emu_read_us, 80, "Emulated latency of a read");
+DEFINE_uint32(ssd_emu_write_us, 20, "Emulated latency of a write");
+DEFINE_uint32(ssd_emu_fsync_us, 200, "Emulated cost of a sync after the in-flight requests completed");
+DEFINE_uint32(ssd_emu_mib_s, 3000, "Emulated bandwidth with a full queue, 0 = unlimited");
+DEFINE_uint32(ssd_emu_queue_depth, 32, "Requests the emulated SSD serves in parallel, fewer in flight get a share of the bandwidth");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(print_debug, true, "");
 DEFINE_bool(print_tx_console, true, "");
 DEFINE_uint32(print_debug_interval_s, 1, "");
 DEFINE_bool(profiling, false, "");
 DEFINE_bool(profile_latency, false, "");
+DEFINE_bool(profile_regions, false, "Attribute cycles, instructions, cache and TLB misses to the engine phases and transaction types");
 DEFINE_bool(crc_check, false, "");
 // -------------------------------------------------------------------------------------
 DEFINE_uint32(worker_threads, 4, "");
@@ -71,9 +83,16 @@ DEFINE_bool(pid_tracing, false, "");
 DEFINE_string(tag, "", "Unique identifier for this, will be appended to each line csv");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(optimistic_parent_pointer, false, "");
+DEFINE_bool(btree_path_hints, true, "Descents record their path so that splits and merges right after them skip the parent search");
 DEFINE_bool(out_of_place, false, "Out of place writes");
 DEFINE_uint64(replacement_chunk_size, 64, "Replacement strategy chunk size");
 DEFINE_bool(recycle_pages, true, "");
+DEFINE_uint32(bm_pinned_levels, 0, "Keep the top x levels of every tree in memory, pinned on the way down");
+DEFINE_uint32(bm_tree_priority, 0, "Eviction priority of the user trees, a page with priority p is cooled on one out of p+1 samples. Internal trees (history trees, graveyards) keep 0 and are evicted first");
+DEFINE_uint32(bm_internal_quota_pct, 0, "Soft quota of the internal trees (history trees, graveyards) in percent of the buffer pool, 0 = unlimited");
+DEFINE_bool(bm_scan_resistant, false, "Leaves swizzled in by a scan stay scan-only until a point access touches them, they are released (evicted when clean) as soon as the scan leaves them");
+DEFINE_double(bm_dirty_target_pct, 0, "Start the page cleaner that writes dirty frames back while more than this pct of the resident ones are dirty");
+DEFINE_uint64(bm_backpressure_us, 0, "Max wait of a worker starting a transaction or loading a page while a partition is below half of its free frames target, 0 = off");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(wal, true, "");
 DEFINE_bool(wal_rfa, true, "Remote Flush Avoidance (RFA)");
@@ -84,6 +103,9 @@ DEFINE_bool(wal_fsync, false, "");
 DEFINE_int64(wal_variant, 0, "");
 DEFINE_uint64(wal_log_writers, 1, "");
 DEFINE_uint64(wal_buffer_size, 1024 * 1024 * 10, "");
+DEFINE_uint64(wal_precommitted_queue_size, 1024 * 16, "Initial capacity of each worker pre-committed transactions ring, a full ring doubles");
+DEFINE_uint64(wal_commit_latency_target_us, 0, "Hold group commit rounds back to batch flushes while meeting this commit latency, 0: flush asap");
+DEFINE_uint64(wal_max_park_us, 1000, "Upper bound of the idle group committer back-off, 0: spin");
 // -------------------------------------------------------------------------------------
 DEFINE_string(isolation_level, "si", "options: ru (READ_UNCOMMITTED), rc (READ_COMMITTED), si (SNAPSHOT_ISOLATION), ser (SERIALIZABLE)");
 DEFINE_bool(mv, true, "Multi-version");
@@ -96,7 +118,7 @@ DEFINE_bool(vi_utodo, true, "");
 DEFINE_bool(vi_rtodo, true, "");
 DEFINE_bool(vi_flookup, false, "");
 DEFINE_bool(vi_fremove, false, "");
-DEFINE_bool(vi_update_version_elision, false, "");
+DEFINE_bool(vi_update_version_elision, false, "OLTP updates skip the history version when the before-image is visible for all, overlapping readers abort (retryable)");
 DEFINE_bool(vi_fupdate_chained, false, "");
 DEFINE_bool(vi_fupdate_fat_tuple, false, "");
 DEFINE_uint64(vi_pgc_batch_size, 2, "");
@@ -106,6 +128,10 @@ DEFINE_bool(vi_fat_tuple_decompose, true, "");
 DEFINE_uint64(vi_fat_tuple_trigger, 0, "1: oldest_oltp, 1: probability");
 DEFINE_bool(vi_fat_tuple_alternative, false, "hit the previous version at every update");
 DEFINE_bool(vi_dangling_pointer, true, "");
+DEFINE_uint64(vi_cold_replica_segment_rows, 4096, "Max rows per segment of the columnar replica of cold ranges");
+DEFINE_uint64(vi_cold_replica_interval_ms, 1000, "Pause between two refresh rounds of the columnar replicas");
+DEFINE_uint64(vi_inline_versions, 0, "Copies of the latest n update versions kept inline behind the chained tuple, 0 disables");
+DEFINE_uint64(vi_inline_version_max_length, 64, "Larger update versions are only kept in the history tree");
 // -------------------------------------------------------------------------------------
 DEFINE_bool(olap_mode, true, "Use OLAP mode for long running transactions");
 DEFINE_bool(graveyard, true, "Use Graveyard Index");
@@ -121,3 +147,8 @@ DEFINE_bool(persist, false, "");
 DEFINE_bool(recover, false, "");
 DEFINE_string(persist_file, "./leanstore.json", "Where should the persist config be saved to?");
 DEFINE_string(recover_file, "./leanstore.json", "Where should the recover config be loaded from?");
+DEFINE_bool(warm_restart, false, "Persist the PIDs of the hot pages next to the persist file and reload them on recovery");
+DEFINE_uint64(hot_pages_interval_s, 0, "Re-record the hot pages every x seconds, 0: only at shutdown");
+DEFINE_bool(persist_freeze, false, "Drop the write permissions of the persisted SSD files and catalog, the image can then only be cloned");
+DEFINE_string(clone_from, "", "Recover a copy-on-write clone of this persisted image into ssd_path, the image is only read");
+DEFINE_string(clone_mode, "auto", "reflink|overlay|auto: share the extents of the image, keep a sparse delta over it, or try reflink first");
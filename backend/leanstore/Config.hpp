@@ -14,7 +14,18 @@ DECLARE_uint32(free_pct);
 DECLARE_uint32(partition_bits);
 DECLARE_uint32(write_buffer_size);
 DECLARE_uint32(falloc);
+DECLARE_uint32(ssd_grow_gib);
+DECLARE_uint32(ssd_trim_batch);
+DECLARE_bool(ssd_emulated);
+DECLARE_double(ssd_emu_dram_gib);
+DECLARE_uint32(ssd_emu_read_us);
+DECLARE_uint32(ssd_emu_write_us);
+DECLARE_uint32(ssd_emu_fsync_us);
+DECLARE_uint32(ssd_emu_mib_s);
+DECLARE_uint32(ssd_emu_queue_depth);
 DECLARE_uint32(pp_threads);
+DECLARE_bool(prefetch);
+DECLARE_uint32(prefetch_batch_size);
 DECLARE_bool(worker_page_eviction);
 DECLARE_bool(trunc);
 DECLARE_bool(root);
@@ -22,6 +33,7 @@ DECLARE_bool(print_debug);
 DECLARE_bool(print_tx_console);
 DECLARE_bool(profiling);
 DECLARE_bool(profile_latency);
+DECLARE_bool(profile_regions);
 DECLARE_bool(crc_check);
 DECLARE_uint32(print_debug_interval_s);
 // -------------------------------------------------------------------------------------
@@ -65,9 +77,16 @@ DECLARE_bool(pid_tracing;)
 DECLARE_string(tag);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(optimistic_parent_pointer);
+DECLARE_bool(btree_path_hints);
 DECLARE_bool(out_of_place);
 DECLARE_uint64(replacement_chunk_size);
 DECLARE_bool(recycle_pages);
+DECLARE_uint32(bm_pinned_levels);
+DECLARE_uint32(bm_tree_priority);
+DECLARE_uint32(bm_internal_quota_pct);
+DECLARE_bool(bm_scan_resistant);
+DECLARE_double(bm_dirty_target_pct);
+DECLARE_uint64(bm_backpressure_us);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(wal);
 DECLARE_bool(wal_rfa);
@@ -78,6 +97,9 @@ DECLARE_bool(wal_fsync);
 DECLARE_int64(wal_variant);
 DECLARE_uint64(wal_log_writers);
 DECLARE_uint64(wal_buffer_size);
+DECLARE_uint64(wal_precommitted_queue_size);
+DECLARE_uint64(wal_commit_latency_target_us);
+DECLARE_uint64(wal_max_park_us);
 // -------------------------------------------------------------------------------------
 DECLARE_string(isolation_level);
 DECLARE_bool(mv);
@@ -100,6 +122,10 @@ DECLARE_bool(vi_fat_tuple);
 DECLARE_string(vi_fat_tuple_dts);
 DECLARE_bool(vi_dangling_pointer);
 DECLARE_bool(vi_fat_tuple_decompose);
+DECLARE_uint64(vi_cold_replica_segment_rows);
+DECLARE_uint64(vi_cold_replica_interval_ms);
+DECLARE_uint64(vi_inline_versions);
+DECLARE_uint64(vi_inline_version_max_length);
 // -------------------------------------------------------------------------------------
 DECLARE_bool(olap_mode);
 DECLARE_bool(graveyard);
@@ -115,3 +141,8 @@ DECLARE_bool(persist);
 DECLARE_bool(recover);
 DECLARE_string(persist_file);
 DECLARE_string(recover_file);
+DECLARE_bool(warm_restart);
+DECLARE_uint64(hot_pages_interval_s);
+DECLARE_bool(persist_freeze);
+DECLARE_string(clone_from);
+DECLARE_string(clone_mode);
@@ -2,7 +2,11 @@
 #include "Units.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <string>
+#include <vector>
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 namespace leanstore
@@ -39,6 +43,9 @@ struct UpdateSameSizeInPlaceDescriptor {
    }
 };
 // -------------------------------------------------------------------------------------
+using Slice = std::basic_string_view<u8>;
+using StringU = std::basic_string<u8>;
+// -------------------------------------------------------------------------------------
 // Interface
 class KVInterface
 {
@@ -50,6 +57,67 @@ class KVInterface
                                            std::function<void(u8* value, u16 value_size)>,
                                            UpdateSameSizeInPlaceDescriptor&) = 0;
    virtual OP_RESULT remove(u8* key, u16 key_length) = 0;
+   // Variable-size update: new_value_length maps the current value length to the new one (false rejects the update with OTHER),
+   // then the callback writes the new value given a copy of the current one
+   virtual OP_RESULT updateVariableSize(u8*,
+                                        u16,
+                                        std::function<bool(u16 value_length, u16& new_value_length)>,
+                                        std::function<void(const u8* value, u16 value_length, u8* new_value, u16 new_value_length)>)
+   {
+      return OP_RESULT::OTHER;
+   }
+   OP_RESULT updateVariableSize(u8* key,
+                                u16 key_length,
+                                u16 new_value_length,
+                                std::function<void(const u8* value, u16 value_length, u8* new_value, u16 new_value_length)> callback)
+   {
+      return updateVariableSize(
+          key, key_length,
+          [&](u16, u16& length) {
+             length = new_value_length;
+             return true;
+          },
+          callback);
+   }
+   // Replaces removed_length bytes at offset with bytes_length new bytes, the tail of the value moves accordingly
+   OP_RESULT splice(u8* key, u16 key_length, u16 offset, u16 removed_length, const u8* bytes, u16 bytes_length)
+   {
+      return updateVariableSize(
+          key, key_length,
+          [&](u16 value_length, u16& new_value_length) {
+             if (u32(offset) + removed_length > value_length || u32(value_length) - removed_length + bytes_length > std::numeric_limits<u16>::max()) {
+                return false;
+             }
+             new_value_length = value_length - removed_length + bytes_length;
+             return true;
+          },
+          [&](const u8* value, u16 value_length, u8* new_value, u16) {
+             std::memcpy(new_value, value, offset);
+             std::memcpy(new_value + offset, bytes, bytes_length);
+             std::memcpy(new_value + offset + bytes_length, value + offset + removed_length, value_length - offset - removed_length);
+          });
+   }
+   // Inserts the pairs in ascending key order, stops at the first result that is not OK (see WriteBatch)
+   virtual OP_RESULT insertSorted(const std::vector<std::pair<Slice, Slice>>& kvs)
+   {
+      for (const auto& [key, value] : kvs) {
+         const OP_RESULT ret = insert(const_cast<u8*>(key.data()), key.length(), const_cast<u8*>(value.data()), value.length());
+         if (ret != OP_RESULT::OK) {
+            return ret;
+         }
+      }
+      return OP_RESULT::OK;
+   }
+   // Asynchronously reads the evicted pages on the paths to the keys and returns at once, the accesses that follow hit warm pages
+   virtual void prefetch(const std::vector<Slice>&) {}
+   // Single descent write: inserts the key or replaces its value
+   virtual OP_RESULT upsert(u8*, u16, u8*, u16) { return OP_RESULT::OTHER; }
+   // Atomic read-modify-write: merge_fn folds the operand into the current value in place, a missing key gets the operand as value
+   // Same-size only, update_descriptor covers the bytes merge_fn may change
+   virtual OP_RESULT merge(u8*, u16, u8*, u16, std::function<void(u8* value, u16 value_length)>, UpdateSameSizeInPlaceDescriptor&)
+   {
+      return OP_RESULT::OTHER;
+   }
    virtual OP_RESULT scanAsc(u8* start_key,
                              u16 key_length,
                              std::function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
@@ -69,8 +137,6 @@ class KVInterface
    virtual OP_RESULT rangeRemove(u8*, u16, u8*, u16, [[maybe_unused]] bool page_wise = true) { return OP_RESULT::OTHER; }
 };
 // -------------------------------------------------------------------------------------
-using Slice = std::basic_string_view<u8>;
-using StringU = std::basic_string<u8>;
 struct MutableSlice {
    u8* ptr;
    u64 len;
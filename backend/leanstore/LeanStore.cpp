@@ -8,6 +8,10 @@
 #include "leanstore/profiling/tables/CRTable.hpp"
 #include "leanstore/profiling/tables/DTTable.hpp"
 #include "leanstore/profiling/tables/LatencyTable.hpp"
+#include "leanstore/profiling/tables/RegionTable.hpp"
+#include "leanstore/storage/io/EmulatedDevice.hpp"
+#include "leanstore/storage/io/OverlayDevice.hpp"
+#include "leanstore/storage/io/PosixDevice.hpp"
 #include "leanstore/utils/FVector.hpp"
 #include "leanstore/utils/ThreadLocalAggregator.hpp"
 // -------------------------------------------------------------------------------------
@@ -22,6 +26,7 @@
 #include <stdio.h>
 #include <sys/ioctl.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -34,9 +39,13 @@ namespace rs = rapidjson;
 namespace leanstore
 {
 // -------------------------------------------------------------------------------------
-LeanStore::LeanStore()
+LeanStore::LeanStore(const string& ssd_path) : ssd_path(ssd_path)
 {
    // LeanStore::addStringFlag("ssd_path", &FLAGS_ssd_path);
+   if (!FLAGS_clone_from.empty()) {
+      FLAGS_recover_file = FLAGS_clone_from;
+      FLAGS_recover = true;
+   }
    if (FLAGS_recover_file != "./leanstore.json") {
       FLAGS_recover = true;
    }
@@ -54,6 +63,24 @@ LeanStore::LeanStore()
    if (FLAGS_isolation_level == "si" && (!FLAGS_mv | !FLAGS_vi)) {
       SetupFailed("You have to enable mv an vi (multi-versioning)");
    }
+   if (!FLAGS_clone_from.empty()) {
+      if (FLAGS_persist && (FLAGS_persist_file == FLAGS_clone_from || storage::io::sameFile(FLAGS_persist_file, FLAGS_clone_from))) {
+         SetupFailed("A clone can not be persisted over its image");
+      }
+      if (FLAGS_ssd_emulated && FLAGS_ssd_emu_dram_gib > 0) {
+         SetupFailed("A clone needs files, disable ssd_emu_dram_gib");
+      }
+      // Compared by inode, the image records absolute paths and the clone would truncate any of them
+      std::stringstream paths(ssd_path);
+      for (string path; std::getline(paths, path, ',');) {
+         std::stringstream image_paths(image_ssd_path);
+         for (string image_path; std::getline(image_paths, image_path, ',');) {
+            if (storage::io::sameFile(path, image_path)) {
+               SetupFailed("The SSD " + path + " of the clone belongs to its image, choose another ssd_path");
+            }
+         }
+      }
+   }
    // -------------------------------------------------------------------------------------
    // Set the default logger to file logger
    // Init SSD pool
@@ -61,44 +88,94 @@ LeanStore::LeanStore()
    if (FLAGS_trunc) {
       flags |= O_TRUNC | O_CREAT;
    }
-   ssd_fd = open(FLAGS_ssd_path.c_str(), flags, 0666);
-   if (ssd_fd == -1) {
-      perror("posix error");
-      std::cout << "path: " << FLAGS_ssd_path << std::endl;
-      SetupFailed("Could not open the file or the SSD block device");
-   }
-   if (FLAGS_falloc > 0) {
-      const u64 gib_size = 1024ull * 1024ull * 1024ull;
-      auto dummy_data = (u8*)aligned_alloc(512, gib_size);
-      for (u64 i = 0; i < FLAGS_falloc; i++) {
-         const int ret = pwrite(ssd_fd, dummy_data, gib_size, gib_size * i);
-         posix_check(ret == gib_size);
+   // The data pages are striped over all listed SSDs, the WAL goes to the first one
+   // A clone opens each of its SSDs as a copy-on-write clone of the image's SSD at the same position
+   std::stringstream paths(ssd_path), image_paths(image_ssd_path);
+   for (string path; std::getline(paths, path, ',');) {
+      if (FLAGS_ssd_emulated && FLAGS_ssd_emu_dram_gib > 0) {
+         ssds.push_back(std::make_unique<storage::io::EmulatedDevice>(u64(FLAGS_ssd_emu_dram_gib * 1024 * 1024 * 1024)));
+         continue;
+      }
+      if (!FLAGS_clone_from.empty()) {
+         string image_path;
+         if (!std::getline(image_paths, image_path, ',')) {
+            SetupFailed("The clone has more SSDs than its image");
+         }
+         bool is_overlay;
+         std::unique_ptr<storage::io::StorageDevice> ssd = storage::io::openClone(image_path, path, FLAGS_clone_mode, is_overlay);
+         if (is_overlay && FLAGS_persist) {
+            SetupFailed("An overlay clone can not be persisted, it needs its image. Clone with clone_mode=reflink");
+         }
+         if (FLAGS_ssd_emulated) {
+            ssd = std::make_unique<storage::io::EmulatedDevice>(std::move(ssd));
+         }
+         ssds.push_back(std::move(ssd));
+         continue;
+      }
+      const s32 fd = open(path.c_str(), flags, 0666);
+      if (fd == -1) {
+         perror("posix error");
+         std::cout << "path: " << path << std::endl;
+         SetupFailed("Could not open the file or the SSD block device");
+      }
+      if (FLAGS_falloc > 0) {
+         const u64 gib_size = 1024ull * 1024ull * 1024ull;
+         auto dummy_data = (u8*)aligned_alloc(512, gib_size);
+         for (u64 i = 0; i < FLAGS_falloc; i++) {
+            const int ret = pwrite(fd, dummy_data, gib_size, gib_size * i);
+            posix_check(ret == gib_size);
+         }
+         free(dummy_data);
+         fsync(fd);
       }
-      free(dummy_data);
-      fsync(ssd_fd);
+      ensure(fcntl(fd, F_GETFL) != -1);
+      std::unique_ptr<storage::io::StorageDevice> ssd = std::make_unique<storage::io::PosixDevice>(fd);
+      if (FLAGS_ssd_emulated) {
+         ssd = std::make_unique<storage::io::EmulatedDevice>(std::move(ssd));
+      }
+      ssds.push_back(std::move(ssd));
+   }
+   if (ssds.empty()) {
+      SetupFailed("No SSD given");
+   }
+   if (string image_path; std::getline(image_paths, image_path, ',')) {
+      SetupFailed("The clone has fewer SSDs than its image");
    }
-   ensure(fcntl(ssd_fd, F_GETFL) != -1);
    // -------------------------------------------------------------------------------------
-   buffer_manager = make_unique<storage::BufferManager>(ssd_fd);
+   std::vector<storage::io::StorageDevice*> ssd_devices;
+   for (auto& ssd : ssds) {
+      ssd_devices.push_back(ssd.get());
+   }
+   buffer_manager = make_unique<storage::BufferManager>(ssd_devices);
    BMC::global_bf = buffer_manager.get();
    // -------------------------------------------------------------------------------------
-   DTRegistry::global_dt_registry.registerDatastructureType(0, storage::btree::BTreeLL::getMeta());
-   DTRegistry::global_dt_registry.registerDatastructureType(2, storage::btree::BTreeVI::getMeta());
+   buffer_manager->getDTRegistry().registerDatastructureType(0, storage::btree::BTreeLL::getMeta());
+   buffer_manager->getDTRegistry().registerDatastructureType(2, storage::btree::BTreeVI::getMeta());
+   if (FLAGS_bm_internal_quota_pct) {
+      buffer_manager->getDTRegistry().setQuota(DTRegistry::internal_quota_group, buffer_manager->getPoolSize() * FLAGS_bm_internal_quota_pct / 100, 0);
+   }
    // -------------------------------------------------------------------------------------
    if (FLAGS_recover) {
       deserializeState();
+      if (FLAGS_warm_restart) {
+         const auto warm_up_begin = std::chrono::high_resolution_clock::now();
+         const u64 loaded_pages = buffer_manager->warmUp(FLAGS_recover_file + ".hot_pages");
+         const auto warm_up_end = std::chrono::high_resolution_clock::now();
+         cout << "Warm restart: loaded " << loaded_pages << " pages in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(warm_up_end - warm_up_begin).count() << " ms" << endl;
+      }
    }
    // -------------------------------------------------------------------------------------
    u64 end_of_block_device;
    if (FLAGS_wal_offset_gib == 0) {
-      ioctl(ssd_fd, BLKGETSIZE64, &end_of_block_device);
+      end_of_block_device = ssds.front()->capacity();
    } else {
       end_of_block_device = FLAGS_wal_offset_gib * 1024 * 1024 * 1024;
    }
    // -------------------------------------------------------------------------------------
    history_tree = std::make_unique<cr::HistoryTree>();
-   cr_manager = make_unique<cr::CRManager>(*history_tree.get(), ssd_fd, end_of_block_device);
-   cr::CRManager::global = cr_manager.get();
+   cr_manager = make_unique<cr::CRManager>(*history_tree.get(), *ssds.front(), end_of_block_device);
+   bindThisThread();
    cr_manager->scheduleJobSync(0, [&]() {
       history_tree->update_btrees = std::make_unique<leanstore::storage::btree::BTreeLL*[]>(FLAGS_worker_threads);
       history_tree->remove_btrees = std::make_unique<leanstore::storage::btree::BTreeLL*[]>(FLAGS_worker_threads);
@@ -110,11 +187,21 @@ LeanStore::LeanStore()
    });
    // -------------------------------------------------------------------------------------
    buffer_manager->startBackgroundThreads();
+   if (FLAGS_persist && FLAGS_warm_restart && FLAGS_hot_pages_interval_s) {
+      startHotPagesThread();
+   }
+}
+// -------------------------------------------------------------------------------------
+void LeanStore::bindThisThread()
+{
+   BMC::global_bf = buffer_manager.get();
+   cr::CRManager::global = cr_manager.get();
 }
 // -------------------------------------------------------------------------------------
 void LeanStore::startProfilingThread()
 {
    std::thread profiling_thread([&]() {
+      bindThisThread();
       utils::pinThisThread(((FLAGS_pin_threads) ? FLAGS_worker_threads : 0) + FLAGS_wal + FLAGS_pp_threads);
       if (FLAGS_root) {
          posix_check(setpriority(PRIO_PROCESS, 0, -20) == 0);
@@ -125,10 +212,14 @@ void LeanStore::startProfilingThread()
       profiling::CPUTable cpu_table;
       profiling::CRTable cr_table;
       profiling::LatencyTable latency_table;
+      profiling::RegionTable region_table;
       std::vector<profiling::ProfilingTable*> tables = {&configs_table, &bm_table, &dt_table, &cpu_table, &cr_table};
       if (FLAGS_profile_latency) {
          tables.push_back(&latency_table);
       }
+      if (FLAGS_profile_regions) {
+         tables.push_back(&region_table);
+      }
       // -------------------------------------------------------------------------------------
       std::vector<std::ofstream> csvs;
       std::ofstream::openmode open_flags;
@@ -238,11 +329,54 @@ void LeanStore::startProfilingThread()
    profiling_thread.detach();
 }
 // -------------------------------------------------------------------------------------
+void LeanStore::startColdReplicaThread()
+{
+   std::thread cold_replica_thread([&]() {
+      pthread_setname_np(pthread_self(), "cold_replica");
+      bindThisThread();
+      cr_manager->registerMeAsSpecialWorker();
+      while (bg_threads_keep_running) {
+         // Trees are registered before the thread starts, the catalog does not change underneath us
+         for (auto& iter : btrees_vi) {
+            if (!bg_threads_keep_running) {
+               break;
+            }
+            iter.second.refreshColdReplica();
+         }
+         for (u64 slept_ms = 0; bg_threads_keep_running && slept_ms < FLAGS_vi_cold_replica_interval_ms; slept_ms += 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         }
+      }
+      bg_threads_counter--;
+   });
+   bg_threads_counter++;
+   cold_replica_thread.detach();
+}
+// -------------------------------------------------------------------------------------
+void LeanStore::startHotPagesThread()
+{
+   std::thread hot_pages_thread([&]() {
+      pthread_setname_np(pthread_self(), "hot_pages");
+      bindThisThread();
+      while (bg_threads_keep_running) {
+         for (u64 slept_ms = 0; bg_threads_keep_running && slept_ms < FLAGS_hot_pages_interval_s * 1000; slept_ms += 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         }
+         if (bg_threads_keep_running) {
+            buffer_manager->recordHotPages(FLAGS_persist_file + ".hot_pages");
+         }
+      }
+      bg_threads_counter--;
+   });
+   bg_threads_counter++;
+   hot_pages_thread.detach();
+}
+// -------------------------------------------------------------------------------------
 storage::btree::BTreeLL& LeanStore::registerBTreeLL(string name, storage::btree::BTreeGeneric::Config config)
 {
    assert(btrees_ll.find(name) == btrees_ll.end());
    auto& btree = btrees_ll[name];
-   DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(0, reinterpret_cast<void*>(&btree), name);
+   DTID dtid = buffer_manager->getDTRegistry().registerDatastructureInstance(0, reinterpret_cast<void*>(&btree), name);
    btree.create(dtid, config);
    return btree;
 }
@@ -252,7 +386,7 @@ storage::btree::BTreeVI& LeanStore::registerBTreeVI(string name, storage::btree:
 {
    assert(btrees_vi.find(name) == btrees_vi.end());
    auto& btree = btrees_vi[name];
-   DTID dtid = DTRegistry::global_dt_registry.registerDatastructureInstance(2, reinterpret_cast<void*>(&btree), name);
+   DTID dtid = buffer_manager->getDTRegistry().registerDatastructureInstance(2, reinterpret_cast<void*>(&btree), name);
    auto& graveyard_btree = registerBTreeLL("_" + name + "_graveyard", {.enable_wal = false, .use_bulk_insert = false});
    btree.create(dtid, config, &graveyard_btree);
    return btree;
@@ -298,7 +432,7 @@ void LeanStore::serializeState()
    d.AddMember("buffer_manager", bm_serialized, allocator);
    // -------------------------------------------------------------------------------------
    rs::Value dts(rs::kArrayType);
-   for (auto& dt : DTRegistry::global_dt_registry.dt_instances_ht) {
+   for (auto& dt : buffer_manager->getDTRegistry().dt_instances_ht) {
       if (std::get<2>(dt.second).substr(0, 1) == "_") {
          continue;
       }
@@ -310,7 +444,7 @@ void LeanStore::serializeState()
       dt_json_object.AddMember("type", rs::Value(std::get<0>(dt.second)), allocator);
       dt_json_object.AddMember("id", rs::Value(dt_id), allocator);
       // -------------------------------------------------------------------------------------
-      std::unordered_map<std::string, std::string> serialized_dt_map = DTRegistry::global_dt_registry.serialize(dt_id);
+      std::unordered_map<std::string, std::string> serialized_dt_map = buffer_manager->getDTRegistry().serialize(dt_id);
       rs::Value dt_serialized(rs::kObjectType);
       for (const auto& [key, value] : serialized_dt_map) {
          rs::Value k, v;
@@ -324,6 +458,21 @@ void LeanStore::serializeState()
    }
    d.AddMember("registered_datastructures", dts, allocator);
    // -------------------------------------------------------------------------------------
+   // Absolute paths, clones may run in another directory
+   string ssd_paths;
+   std::stringstream paths(ssd_path);
+   for (string path; std::getline(paths, path, ',');) {
+      char* absolute_path = realpath(path.c_str(), nullptr);
+      if (!ssd_paths.empty()) {
+         ssd_paths += ",";
+      }
+      ssd_paths += absolute_path ? absolute_path : path.c_str();
+      free(absolute_path);
+   }
+   rs::Value ssd_paths_value;
+   ssd_paths_value.SetString(ssd_paths.c_str(), ssd_paths.length(), allocator);
+   d.AddMember("ssd_path", ssd_paths_value, allocator);
+   // -------------------------------------------------------------------------------------
    serializeFlags(d);
    rs::StringBuffer sb;
    rs::PrettyWriter<rs::StringBuffer> writer(sb);
@@ -372,6 +521,7 @@ void LeanStore::deserializeState()
       serialized_bm_map[itr->name.GetString()] = itr->value.GetString();
    }
    buffer_manager->deserialize(serialized_bm_map);
+   buffer_manager->loadFreePages(FLAGS_recover_file + ".free_pages");
    // -------------------------------------------------------------------------------------
    const rs::Value& dts = d["registered_datastructures"];
    assert(dts.IsArray());
@@ -388,14 +538,14 @@ void LeanStore::deserializeState()
       // -------------------------------------------------------------------------------------
       if (dt_type == 0) {
          auto& btree = btrees_ll[dt_name];
-         DTRegistry::global_dt_registry.registerDatastructureInstance(0, reinterpret_cast<void*>(&btree), dt_name, dt_id);
+         buffer_manager->getDTRegistry().registerDatastructureInstance(0, reinterpret_cast<void*>(&btree), dt_name, dt_id);
       } else if (dt_type == 2) {
          auto& btree = btrees_vi[dt_name];
-         DTRegistry::global_dt_registry.registerDatastructureInstance(2, reinterpret_cast<void*>(&btree), dt_name, dt_id);
+         buffer_manager->getDTRegistry().registerDatastructureInstance(2, reinterpret_cast<void*>(&btree), dt_name, dt_id);
       } else {
          UNREACHABLE();
       }
-      DTRegistry::global_dt_registry.deserialize(dt_id, serialized_dt_map);
+      buffer_manager->getDTRegistry().deserialize(dt_id, serialized_dt_map);
    }
 }
 // -------------------------------------------------------------------------------------
@@ -418,10 +568,17 @@ void LeanStore::deserializeFlags()
    for (auto flags : persisted_s64_flags) {
       *std::get<1>(flags) = atoi(flags_serialized[std::get<0>(flags)].c_str());
    }
+   if (!FLAGS_clone_from.empty()) {
+      if (!d.HasMember("ssd_path")) {
+         SetupFailed("The image " + FLAGS_clone_from + " does not record its SSDs, persist it again to clone it");
+      }
+      image_ssd_path = d["ssd_path"].GetString();
+   }
 }
 // -------------------------------------------------------------------------------------
 LeanStore::~LeanStore()
 {
+   bindThisThread();
    if (FLAGS_btree_print_height || FLAGS_btree_print_tuples_count) {
       cr_manager->joinAll();
       for (auto& iter : btrees_ll) {
@@ -450,7 +607,36 @@ LeanStore::~LeanStore()
    }
    if (FLAGS_persist) {
       serializeState();
+      if (FLAGS_warm_restart) {
+         buffer_manager->recordHotPages(FLAGS_persist_file + ".hot_pages");
+      }
       buffer_manager->writeAllBufferFrames();
+      buffer_manager->recordFreePages(FLAGS_persist_file + ".free_pages");
+      if (FLAGS_persist_freeze) {
+         freezeImage();
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+// Only clones (clone_from) can start from a frozen image, recovering it directly fails to open the SSDs for writing
+void LeanStore::freezeImage()
+{
+   std::vector<string> image_files = {FLAGS_persist_file, FLAGS_persist_file + ".free_pages", FLAGS_persist_file + ".hot_pages"};
+   if (!(FLAGS_ssd_emulated && FLAGS_ssd_emu_dram_gib > 0)) {
+      std::stringstream paths(ssd_path);
+      for (string path; std::getline(paths, path, ',');) {
+         image_files.push_back(path);
+      }
+   }
+   for (auto& ssd : ssds) {
+      ssd->sync();
+   }
+   for (auto& path : image_files) {
+      struct stat st;
+      // Block devices keep their permissions
+      if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+         posix_check(chmod(path.c_str(), st.st_mode & ~(S_IWUSR | S_IWGRP | S_IWOTH)) == 0);
+      }
    }
 }
 // -------------------------------------------------------------------------------------
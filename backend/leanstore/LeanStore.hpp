@@ -2,6 +2,7 @@
 #include "Config.hpp"
 #include "leanstore/concurrency-recovery/HistoryTree.hpp"
 #include "leanstore/profiling/tables/ConfigsTable.hpp"
+#include "leanstore/storage/btree/BTreeCursor.hpp"
 #include "leanstore/storage/btree/BTreeLL.hpp"
 #include "leanstore/storage/btree/BTreeVI.hpp"
 #include "leanstore/storage/buffer-manager/BufferManager.hpp"
@@ -25,7 +26,9 @@ class LeanStore
    std::unordered_map<string, storage::btree::BTreeLL> btrees_ll;
    std::unordered_map<string, storage::btree::BTreeVI> btrees_vi;
    // -------------------------------------------------------------------------------------
-   s32 ssd_fd;
+   const string ssd_path;
+   std::vector<std::unique_ptr<storage::io::StorageDevice>> ssds;  // data stripes, the first one also holds the WAL
+   string image_ssd_path;  // the SSDs of the image recorded in the catalog, when cloning
    // -------------------------------------------------------------------------------------
    unique_ptr<storage::BufferManager> buffer_manager;
    unique_ptr<cr::CRManager> cr_manager;
@@ -45,10 +48,15 @@ class LeanStore
    void deserializeFlags();
    void serializeState();
    void deserializeState();
+   void startHotPagesThread();
+   void freezeImage();
 
   public:
-   LeanStore();
+   // Several instances can live in one process, each with its own buffer pool, WAL and workers. They share the flags except for the SSD
+   // path. Threads are bound to one instance at a time: the threads of an instance are bound to it, other threads call bindThisThread()
+   LeanStore(const string& ssd_path = FLAGS_ssd_path);
    ~LeanStore();
+   void bindThisThread();
    // -------------------------------------------------------------------------------------
    template <typename T>
    void registerConfigEntry(string name, T value)
@@ -75,6 +83,8 @@ class LeanStore
    cr::CRManager& getCRManager() { return *cr_manager; }
    // -------------------------------------------------------------------------------------
    void startProfilingThread();
+   // Keeps the columnar replicas of the BTreeVIs that enabled one up to date, start after registering all trees
+   void startColdReplicaThread();
    // -------------------------------------------------------------------------------------
    static void addStringFlag(string name, fLS::clstring* flag) { persisted_string_flags.push_back(std::make_tuple(name, flag)); }
    static void addS64Flag(string name, s64* flag) { persisted_s64_flags.push_back(std::make_tuple(name, flag)); }
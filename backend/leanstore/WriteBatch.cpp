@@ -0,0 +1,52 @@
+#include "WriteBatch.hpp"
+
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+// -------------------------------------------------------------------------------------
+void WriteBatch::insert(KVInterface& tree, const u8* key, u16 key_length, const u8* value, u16 value_length)
+{
+   operations.push_back({&tree, buffer.length(), key_length, value_length});
+   buffer.append(key, key_length);
+   buffer.append(value, value_length);
+}
+// -------------------------------------------------------------------------------------
+void WriteBatch::clear()
+{
+   buffer.clear();
+   operations.clear();
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT WriteBatch::apply()
+{
+   std::vector<const Operation*> sorted;
+   sorted.reserve(operations.size());
+   for (const Operation& operation : operations) {
+      sorted.push_back(&operation);
+   }
+   std::stable_sort(sorted.begin(), sorted.end(), [&](const Operation* a, const Operation* b) {
+      if (a->tree != b->tree) {
+         return a->tree < b->tree;
+      }
+      return a->key(buffer) < b->key(buffer);
+   });
+   // -------------------------------------------------------------------------------------
+   std::vector<std::pair<Slice, Slice>> kvs;
+   for (u64 op_i = 0; op_i < sorted.size();) {
+      KVInterface* tree = sorted[op_i]->tree;
+      kvs.clear();
+      for (; op_i < sorted.size() && sorted[op_i]->tree == tree; op_i++) {
+         kvs.emplace_back(sorted[op_i]->key(buffer), sorted[op_i]->value(buffer));
+      }
+      const OP_RESULT ret = tree->insertSorted(kvs);
+      if (ret != OP_RESULT::OK) {
+         return ret;
+      }
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+}  // namespace leanstore
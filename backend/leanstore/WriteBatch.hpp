@@ -0,0 +1,38 @@
+#pragma once
+#include "KVInterface.hpp"
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+// -------------------------------------------------------------------------------------
+// Collects the inserts of a transaction and applies them sorted by tree and key (KVInterface::insertSorted)
+// The B-trees insert each run of keys that falls into the same leaf under one latch with one WAL entry
+class WriteBatch
+{
+  private:
+   struct Operation {
+      KVInterface* tree;
+      u64 offset;  // in buffer, key then value
+      u16 key_length;
+      u16 value_length;
+      Slice key(const StringU& buffer) const { return Slice(buffer.data() + offset, key_length); }
+      Slice value(const StringU& buffer) const { return Slice(buffer.data() + offset + key_length, value_length); }
+   };
+   StringU buffer;
+   std::vector<Operation> operations;
+
+  public:
+   void insert(KVInterface& tree, const u8* key, u16 key_length, const u8* value, u16 value_length);
+   u64 size() const { return operations.size(); }
+   bool empty() const { return operations.empty(); }
+   void clear();
+   // Within the active transaction, stops at the first result that is not OK (e.g. DUPLICATE), the transaction has to abort then
+   // The batch is left untouched
+   OP_RESULT apply();
+};
+// -------------------------------------------------------------------------------------
+}  // namespace leanstore
@@ -2,6 +2,7 @@
 
 #include "leanstore/profiling/counters/CPUCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 #include <mutex>
@@ -12,22 +13,24 @@ namespace cr
 {
 // -------------------------------------------------------------------------------------
 // Threads id order: workers (xN) -> Group Committer Thread (x1) -> Page Provider Threads (xP)
-CRManager* CRManager::global = nullptr;
-std::atomic<u64> CRManager::fsync_counter = 0;
-std::atomic<u64> CRManager::g_ssd_offset = 0;
+thread_local CRManager* CRManager::global = nullptr;
 // -------------------------------------------------------------------------------------
-CRManager::CRManager(HistoryTreeInterface& versions_space, s32 ssd_fd, u64 end_of_block_device)
-    : ssd_fd(ssd_fd), end_of_block_device(end_of_block_device), versions_space(versions_space)
+CRManager::CRManager(HistoryTreeInterface& versions_space, storage::io::StorageDevice& wal_device, u64 end_of_block_device)
+    : wal_device(wal_device), end_of_block_device(end_of_block_device), versions_space(versions_space)
 {
    workers_count = FLAGS_worker_threads;
    g_ssd_offset = end_of_block_device;
    ensure(workers_count < MAX_WORKER_THREADS);
    // -------------------------------------------------------------------------------------
-   Worker::global_workers_current_snapshot = std::make_unique<atomic<u64>[]>(workers_count);
+   workers_global.workers_current_snapshot = std::make_unique<atomic<u64>[]>(workers_count);
    // -------------------------------------------------------------------------------------
+   // The workers serve the instance whose buffer pool the constructing thread is bound to
+   storage::BufferManager* buffer_manager = storage::BMC::global_bf;
    worker_threads.reserve(workers_count);
    for (u64 t_i = 0; t_i < workers_count; t_i++) {
-      worker_threads.emplace_back([&, t_i]() {
+      worker_threads.emplace_back([&, t_i, buffer_manager]() {
+         storage::BMC::global_bf = buffer_manager;
+         CRManager::global = this;
          std::string thread_name("worker_" + std::to_string(t_i));
          pthread_setname_np(pthread_self(), thread_name.c_str());
          if (FLAGS_pin_threads) {
@@ -40,7 +43,7 @@ CRManager::CRManager(HistoryTreeInterface& versions_space, s32 ssd_fd, u64 end_o
          WorkerCounters::myCounters().worker_id = t_i;
          CRCounters::myCounters().worker_id = t_i;
          // -------------------------------------------------------------------------------------
-         workers[t_i] = new Worker(t_i, workers, workers_count, versions_space, ssd_fd);
+         workers[t_i] = new Worker(t_i, workers, workers_count, workers_global, versions_space);
          Worker::tls_ptr = workers[t_i];
          // -------------------------------------------------------------------------------------
          running_threads++;
@@ -93,7 +96,8 @@ CRManager::CRManager(HistoryTreeInterface& versions_space, s32 ssd_fd, u64 end_o
 // -------------------------------------------------------------------------------------
 void CRManager::registerMeAsSpecialWorker()
 {
-   cr::Worker::tls_ptr = new Worker(std::numeric_limits<WORKERID>::max(), workers, workers_count, versions_space, ssd_fd, true);
+   CRManager::global = this;
+   cr::Worker::tls_ptr = new Worker(std::numeric_limits<WORKERID>::max(), workers, workers_count, workers_global, versions_space, true);
 }
 // -------------------------------------------------------------------------------------
 void CRManager::scheduleJobSync(u64 t_i, std::function<void()> job)
@@ -128,6 +132,17 @@ void CRManager::joinAll()
    }
 }
 // -------------------------------------------------------------------------------------
+void CRManager::executeDeterministicBatch(DeterministicBatch& batch, TX_DURABILITY durability)
+{
+   batch.plan(workers_count);
+   for (u32 t_i = 0; t_i < workers_count; t_i++) {
+      if (!batch.partition(t_i).empty()) {
+         setJob(t_i, [&batch, t_i, durability]() { batch.executePartition(t_i, durability); });
+      }
+   }
+   joinAll();
+}
+// -------------------------------------------------------------------------------------
 void CRManager::setJob(u64 t_i, std::function<void()> job)
 {
    ensure(t_i < workers_count);
@@ -152,14 +167,14 @@ void CRManager::joinOne(u64 t_i, std::function<bool(WorkerThread&)> condition)
 std::unordered_map<std::string, std::string> CRManager::serialize()
 {
    std::unordered_map<std::string, std::string> map;
-   map["global_logical_clock"] = std::to_string(Worker::ConcurrencyControl::global_clock.load());
+   map["global_logical_clock"] = std::to_string(workers_global.clock.load());
    return map;
 }
 // -------------------------------------------------------------------------------------
 void CRManager::deserialize(std::unordered_map<std::string, std::string> map)
 {
-   Worker::ConcurrencyControl::global_clock = std::stol(map["global_logical_clock"]);
-   Worker::global_all_lwm = std::stol(map["global_logical_clock"]);
+   workers_global.clock = std::stol(map["global_logical_clock"]);
+   workers_global.all_lwm = std::stol(map["global_logical_clock"]);
 }
 // -------------------------------------------------------------------------------------
 CRManager::~CRManager()
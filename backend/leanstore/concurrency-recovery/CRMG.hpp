@@ -1,9 +1,11 @@
 #pragma once
+#include "DeterministicBatch.hpp"
 #include "Exceptions.hpp"
 #include "HistoryTreeInterface.hpp"
 #include "Units.hpp"
 #include "Worker.hpp"
 #include "leanstore/Config.hpp"
+#include "leanstore/storage/io/StorageDevice.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 #include <atomic>
@@ -25,8 +27,9 @@ class CRManager
 {
   public:
    static constexpr u64 MAX_WORKER_THREADS = std::numeric_limits<WORKERID>::max();
-   static CRManager* global;
+   static thread_local CRManager* global;  // The instance this thread works for
    Worker* workers[MAX_WORKER_THREADS];
+   Worker::Global workers_global;
    // -------------------------------------------------------------------------------------
    std::atomic<u64> running_threads = 0;
    std::atomic<bool> keep_running = true;
@@ -43,11 +46,11 @@ class CRManager
    WorkerThread worker_threads_meta[MAX_WORKER_THREADS];
    u32 workers_count;
    // -------------------------------------------------------------------------------------
-   const s32 ssd_fd;
+   storage::io::StorageDevice& wal_device;  // the first SSD
    const u64 end_of_block_device;
    HistoryTreeInterface& versions_space;
    // -------------------------------------------------------------------------------------
-   CRManager(HistoryTreeInterface&, s32 ssd_fd, u64 end_of_block_device);
+   CRManager(HistoryTreeInterface&, storage::io::StorageDevice& wal_device, u64 end_of_block_device);
    ~CRManager();
    // -------------------------------------------------------------------------------------
    void registerMeAsSpecialWorker();
@@ -85,14 +88,21 @@ class CRManager
     *
     */
    void joinAll();
+   /**
+    * @brief Plans the batch over all workers, runs every partition on its worker and waits for completion.
+    *
+    * @param batch deterministic batch, its trees must not be used by anybody else meanwhile, its logic must not abort
+    * @param durability of the transaction each partition commits as, the logged inputs are not replayed by recovery yet
+    */
+   void executeDeterministicBatch(DeterministicBatch& batch, TX_DURABILITY durability = TX_DURABILITY::GROUP);
    // -------------------------------------------------------------------------------------
    // State Serialization
    std::unordered_map<std::string, std::string> serialize();
    void deserialize(std::unordered_map<std::string, std::string> map);
 
   private:
-   static std::atomic<u64> fsync_counter;
-   static std::atomic<u64> g_ssd_offset;
+   std::atomic<u64> fsync_counter = 0;
+   std::atomic<u64> g_ssd_offset = 0;
    // -------------------------------------------------------------------------------------
    void groupCommiter();
    void groupCommitCordinator();
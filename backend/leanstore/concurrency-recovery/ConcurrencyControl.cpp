@@ -1,5 +1,5 @@
 #include "Worker.hpp"
-#include "leanstore/storage/buffer-manager/DTRegistry.hpp"
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
 // -------------------------------------------------------------------------------------
 #include "leanstore/utils/Misc.hpp"
 // -------------------------------------------------------------------------------------
@@ -10,7 +10,6 @@ namespace leanstore
 namespace cr
 {
 // -------------------------------------------------------------------------------------
-atomic<u64> Worker::ConcurrencyControl::global_clock = WORKERS_INCREMENT;
 // -------------------------------------------------------------------------------------
 // Also for interval garbage collection
 void Worker::ConcurrencyControl::refreshGlobalState()
@@ -20,16 +19,17 @@ void Worker::ConcurrencyControl::refreshGlobalState()
       return;
    }
    utils::Timer timer(CRCounters::myCounters().cc_ms_refresh_global_state);
-   if (utils::RandomGenerator::getRandU64(0, my().workers_count) == 0 && global_mutex.try_lock()) {
+   Global& global = my().global;
+   if (utils::RandomGenerator::getRandU64(0, my().workers_count) == 0 && global.mutex.try_lock()) {
       TXID local_newest_olap = std::numeric_limits<u64>::min();
       TXID local_oldest_oltp = std::numeric_limits<u64>::max();
       TXID local_oldest_tx = std::numeric_limits<u64>::max();
 
       for (WORKERID w_i = 0; w_i < my().workers_count; w_i++) {
-         u64 its_in_flight_tx_id = global_workers_current_snapshot[w_i].load();
+         u64 its_in_flight_tx_id = global.workers_current_snapshot[w_i].load();
          // -------------------------------------------------------------------------------------
          while ((its_in_flight_tx_id & LATCH_BIT) && ((its_in_flight_tx_id & CLEAN_BITS_MASK) < activeTX().startTS())) {
-            its_in_flight_tx_id = global_workers_current_snapshot[w_i].load();
+            its_in_flight_tx_id = global.workers_current_snapshot[w_i].load();
          }
          // -------------------------------------------------------------------------------------
          const bool is_rc = its_in_flight_tx_id & RC_BIT;
@@ -45,9 +45,9 @@ void Worker::ConcurrencyControl::refreshGlobalState()
          }
       }
       // -------------------------------------------------------------------------------------
-      global_oldest_all_start_ts.store(local_oldest_tx, std::memory_order_release);
-      global_oldest_oltp_start_ts.store(local_oldest_oltp, std::memory_order_release);
-      global_newest_olap_start_ts.store(local_newest_olap, std::memory_order_release);
+      global.oldest_all_start_ts.store(local_oldest_tx, std::memory_order_release);
+      global.oldest_oltp_start_ts.store(local_oldest_oltp, std::memory_order_release);
+      global.newest_olap_start_ts.store(local_newest_olap, std::memory_order_release);
       // -------------------------------------------------------------------------------------
       TXID global_all_lwm_buffer = std::numeric_limits<TXID>::max();
       TXID global_oltp_lwm_buffer = std::numeric_limits<TXID>::max();
@@ -60,10 +60,10 @@ void Worker::ConcurrencyControl::refreshGlobalState()
             other(w_i).local_latest_lwm_for_tx.store(other(w_i).local_latest_write_tx, std::memory_order_release);
          }
          // -------------------------------------------------------------------------------------
-         TXID its_all_lwm_buffer = other(w_i).commit_tree.LCB(global_oldest_all_start_ts),
-              its_oltp_lwm_buffer = other(w_i).commit_tree.LCB(global_oldest_oltp_start_ts);
+         TXID its_all_lwm_buffer = other(w_i).commit_tree.LCB(global.oldest_all_start_ts),
+              its_oltp_lwm_buffer = other(w_i).commit_tree.LCB(global.oldest_oltp_start_ts);
          // -------------------------------------------------------------------------------------
-         if (FLAGS_olap_mode && global_oldest_all_start_ts != global_oldest_oltp_start_ts) {
+         if (FLAGS_olap_mode && global.oldest_all_start_ts != global.oldest_oltp_start_ts) {
             // ensure(its_all_lwm_buffer <= its_oltp_lwm_buffer);
             global_oltp_lwm_buffer = std::min<TXID>(its_oltp_lwm_buffer, global_oltp_lwm_buffer);
          } else {
@@ -78,30 +78,32 @@ void Worker::ConcurrencyControl::refreshGlobalState()
          other(w_i).local_lwm_latch.store(other(w_i).local_lwm_latch.load() + 1, std::memory_order_release);  // Release
       }
       if (!skipped_a_worker) {
-         global_all_lwm.store(global_all_lwm_buffer, std::memory_order_release);
-         global_oltp_lwm.store(global_oltp_lwm_buffer, std::memory_order_release);
+         global.all_lwm.store(global_all_lwm_buffer, std::memory_order_release);
+         global.oltp_lwm.store(global_oltp_lwm_buffer, std::memory_order_release);
       }
       // -------------------------------------------------------------------------------------
-      global_mutex.unlock();
+      global.mutex.unlock();
    }
 }
 // -------------------------------------------------------------------------------------
 void Worker::ConcurrencyControl::switchToSnapshotIsolationMode()
 {
+   Global& global = my().global;
    {
-      std::unique_lock guard(global_mutex);
-      global_workers_current_snapshot[my().worker_id].store(global_clock.load(), std::memory_order_release);
+      std::unique_lock guard(global.mutex);
+      global.workers_current_snapshot[my().worker_id].store(global.clock.load(), std::memory_order_release);
    }
    refreshGlobalState();
 }
 // -------------------------------------------------------------------------------------
 void Worker::ConcurrencyControl::switchToReadCommittedMode()
 {
+   Global& global = my().global;
    {
       // Latch-free work only when all counters increase monotone, we can not simply go back
-      std::unique_lock guard(global_mutex);
-      const u64 last_commit_mark_flagged = global_workers_current_snapshot[my().worker_id].load() | RC_BIT;
-      global_workers_current_snapshot[my().worker_id].store(last_commit_mark_flagged, std::memory_order_release);
+      std::unique_lock guard(global.mutex);
+      const u64 last_commit_mark_flagged = global.workers_current_snapshot[my().worker_id].load() | RC_BIT;
+      global.workers_current_snapshot[my().worker_id].store(last_commit_mark_flagged, std::memory_order_release);
    }
    refreshGlobalState();
 }
@@ -132,7 +134,7 @@ synclwm : {
       history_tree.purgeVersions(
           my().worker_id, 0, local_all_lwm - 1,
           [&](const TXID tx_id, const DTID dt_id, const u8* version_payload, [[maybe_unused]] u64 version_payload_length, const bool called_before) {
-             leanstore::storage::DTRegistry::global_dt_registry.todo(dt_id, version_payload, my().worker_id, tx_id, called_before);
+             leanstore::storage::BMC::global_bf->getDTRegistry().todo(dt_id, version_payload, my().worker_id, tx_id, called_before);
              COUNTERS_BLOCK()
              {
                 WorkerCounters::myCounters().cc_todo_olap_executed[dt_id]++;
@@ -150,7 +152,7 @@ synclwm : {
                                           [&](const TXID tx_id, const DTID dt_id, const u8* version_payload,
                                               [[maybe_unused]] u64 version_payload_length, const bool called_before) {
                                              cleaned_untill_oltp_lwm = std::max(cleaned_untill_oltp_lwm, tx_id + 1);
-                                             leanstore::storage::DTRegistry::global_dt_registry.todo(dt_id, version_payload, my().worker_id, tx_id,
+                                             leanstore::storage::BMC::global_bf->getDTRegistry().todo(dt_id, version_payload, my().worker_id, tx_id,
                                                                                                      called_before);
                                              COUNTERS_BLOCK()
                                              {
@@ -208,7 +210,7 @@ bool Worker::ConcurrencyControl::isVisibleForMe(WORKERID other_worker_id, u64 tx
          return true;
       } else {
          utils::Timer timer(CRCounters::myCounters().cc_ms_snapshotting);
-         TXID current_ts = cr::Worker::my().cc.global_clock.load() + 1;
+         TXID current_ts = cr::Worker::my().global.clock.load() + 1;
          TXID largest_visibile_ts_start = other(other_worker_id).commit_tree.LCB(current_ts);
          local_snapshot_cache[other_worker_id] = largest_visibile_ts_start;
          local_snapshot_cache_ts[other_worker_id] = current_ts;
@@ -245,10 +247,10 @@ bool Worker::ConcurrencyControl::isVisibleForAll(WORKERID, TXID ts)
 {
    if (ts & MSB) {
       // Commit Timestamp
-      return (ts & MSB_MASK) < global_oldest_all_start_ts.load();
+      return (ts & MSB_MASK) < my().global.oldest_all_start_ts.load();
    } else {
       // Start Timestamp
-      return ts < global_all_lwm.load();
+      return ts < my().global.all_lwm.load();
    }
 }
 // -------------------------------------------------------------------------------------
@@ -257,7 +259,7 @@ TXID Worker::ConcurrencyControl::CommitTree::commit(TXID start_ts)
    utils::Timer timer(CRCounters::myCounters().cc_ms_committing);
    mutex.lock();
    assert(cursor < capacity);
-   const TXID commit_ts = global_clock.fetch_add(1);
+   const TXID commit_ts = my().global.clock.fetch_add(1);
    array[cursor++] = {commit_ts, start_ts};
    mutex.unlock();
    return commit_ts;
@@ -302,10 +304,10 @@ void Worker::ConcurrencyControl::CommitTree::cleanIfNecessary()
       if (w_i == my_worker_id) {
          continue;
       }
-      u64 its_start_ts = global_workers_current_snapshot[w_i].load();
+      u64 its_start_ts = my().global.workers_current_snapshot[w_i].load();
       // -------------------------------------------------------------------------------------
       while (its_start_ts & LATCH_BIT) {
-         its_start_ts = global_workers_current_snapshot[w_i].load();
+         its_start_ts = my().global.workers_current_snapshot[w_i].load();
       }
       its_start_ts &= Worker::CLEAN_BITS_MASK;
       set.insert(array[cursor - 1]);  // for  the new TX
@@ -0,0 +1,132 @@
+#include "DeterministicBatch.hpp"
+
+#include "Worker.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/storage/btree/BTreeVI.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+OP_RESULT DeterministicBatch::Context::lookup(u64 access_i, std::function<void(const u8* value, u16 value_length)> payload_callback)
+{
+   ensure(access_i < tx.accesses.size());
+   const Access& access = tx.accesses[access_i];
+   return access.btree->lookup(const_cast<u8*>(access.key.data()), access.key.length(), payload_callback);
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT DeterministicBatch::Context::update(u64 access_i,
+                                              std::function<void(u8* value, u16 value_size)> callback,
+                                              UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   ensure(access_i < tx.accesses.size());
+   const Access& access = tx.accesses[access_i];
+   ensure(access.is_write);
+   return access.btree->updateDeterministic(const_cast<u8*>(access.key.data()), access.key.length(), callback, update_descriptor);
+}
+// -------------------------------------------------------------------------------------
+u64 DeterministicBatch::add(TX tx)
+{
+   ensure(sizeof(WALBatchInputEntry) + tx.input.length() <= std::numeric_limits<u16>::max());
+   txs.push_back(std::move(tx));
+   return txs.size() - 1;
+}
+// -------------------------------------------------------------------------------------
+void DeterministicBatch::plan(u64 workers_count)
+{
+   ensure(workers_count > 0);
+   using Key = std::pair<storage::btree::BTreeVI*, std::basic_string<u8>>;
+   // Union-find over transactions, two of them conflict when they access the same key and at least one writes it
+   std::vector<u64> parent(txs.size());
+   for (u64 tx_i = 0; tx_i < txs.size(); tx_i++) {
+      parent[tx_i] = tx_i;
+   }
+   auto find = [&](u64 tx_i) {
+      while (parent[tx_i] != tx_i) {
+         parent[tx_i] = parent[parent[tx_i]];
+         tx_i = parent[tx_i];
+      }
+      return tx_i;
+   };
+   std::set<Key> written;
+   for (const TX& tx : txs) {
+      for (const Access& access : tx.accesses) {
+         if (access.is_write) {
+            written.insert({access.btree, access.key});
+         }
+      }
+   }
+   std::map<Key, u64> first_accessor;
+   for (u64 tx_i = 0; tx_i < txs.size(); tx_i++) {
+      for (const Access& access : txs[tx_i].accesses) {
+         Key key{access.btree, access.key};
+         if (written.find(key) == written.end()) {
+            continue;  // Read by everyone, stays the same throughout the batch
+         }
+         auto [it, inserted] = first_accessor.try_emplace(std::move(key), tx_i);
+         if (!inserted) {
+            // Keep the smaller index as root, so a component is identified by its first transaction
+            const u64 a = find(it->second), b = find(tx_i);
+            parent[std::max(a, b)] = std::min(a, b);
+         }
+      }
+   }
+   // -------------------------------------------------------------------------------------
+   // Components in the order of their first transaction go to the least loaded worker, ties to the lower worker id
+   std::vector<std::vector<u64>> components(txs.size());
+   for (u64 tx_i = 0; tx_i < txs.size(); tx_i++) {
+      components[find(tx_i)].push_back(tx_i);
+   }
+   partitions.assign(workers_count, {});
+   std::vector<u64> load(workers_count, 0);
+   for (u64 root = 0; root < txs.size(); root++) {
+      if (components[root].empty()) {
+         continue;
+      }
+      const u64 w_i = std::min_element(load.begin(), load.end()) - load.begin();
+      load[w_i] += components[root].size();
+      partitions[w_i].insert(partitions[w_i].end(), components[root].begin(), components[root].end());
+   }
+   for (auto& partition : partitions) {
+      std::sort(partition.begin(), partition.end());
+   }
+}
+// -------------------------------------------------------------------------------------
+void DeterministicBatch::executePartition(u64 w_i, TX_DURABILITY durability)
+{
+   ensure(w_i < partitions.size());
+   const auto& my_txs = partitions[w_i];
+   if (my_txs.empty()) {
+      return;
+   }
+   Worker::my().startTX(TX_MODE::DETERMINISTIC, TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION, false, durability);
+   if (FLAGS_wal && durability != TX_DURABILITY::NON_DURABLE) {
+      for (const u64 tx_i : my_txs) {
+         const TX& tx = txs[tx_i];
+         WALBatchInputEntry& entry = Worker::my().logging.reserveWALBatchInputEntry(tx.input.length());
+         entry.batch_id = batch_id;
+         entry.tx_i = tx_i;
+         std::memcpy(entry.payload, tx.input.data(), tx.input.length());
+         Worker::my().logging.submitWALBatchInputEntry();
+      }
+   }
+   for (const u64 tx_i : my_txs) {
+      Context context(txs[tx_i]);
+      txs[tx_i].logic(context);
+   }
+   if (FLAGS_wal) {
+      // Updates advanced the page GSNs without a WAL entry, publish them so that RFA of remote readers waits for our commit
+      Worker::my().logging.publishMaxGSNOffset();
+   }
+   Worker::my().commitTX();
+}
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
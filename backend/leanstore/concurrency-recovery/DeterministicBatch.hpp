@@ -0,0 +1,78 @@
+#pragma once
+#include "Transaction.hpp"
+#include "Units.hpp"
+#include "leanstore/KVInterface.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <functional>
+#include <string>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+class BTreeVI;
+}
+}  // namespace storage
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+// Calvin-style batch of transactions that declare their read and write sets upfront
+// plan() fixes the serial order (= the order of add) and splits the batch into partitions that share no written key,
+// each worker runs its partition in that order as one DETERMINISTIC transaction, so nothing waits on a lock or aborts
+// The WAL gets the input of every transaction only, replaying the inputs of a batch in (batch_id, tx_i) order re-executes it
+// Pre: nobody else writes the trees of the batch and nobody else reads the written keys while the batch runs
+// Updates keep no before-image, snapshots older than the batch commit get ABORT_TX on the written keys
+// Limits: updates of chained tuples write no WAL entry, hence a partition can not abort (abortTX refuses DETERMINISTIC transactions).
+// This tree has no log replay yet, so a batch is only as durable as the pages it dirtied until the replay of the inputs exists
+class DeterministicBatch
+{
+  public:
+   struct Access {
+      storage::btree::BTreeVI* btree;
+      std::basic_string<u8> key;
+      bool is_write;
+   };
+   class Context;
+   struct TX {
+      std::vector<Access> accesses;
+      std::basic_string<u8> input;  // Opaque to the batch, logged and handed back to the logic
+      std::function<void(Context&)> logic;
+   };
+   // What the logic of a TX can touch: only the keys it declared, addressed by their position in TX::accesses
+   class Context
+   {
+     private:
+      const TX& tx;
+
+     public:
+      Context(const TX& tx) : tx(tx) {}
+      const std::basic_string<u8>& input() const { return tx.input; }
+      OP_RESULT lookup(u64 access_i, std::function<void(const u8* value, u16 value_length)> payload_callback);
+      OP_RESULT update(u64 access_i, std::function<void(u8* value, u16 value_size)> callback, UpdateSameSizeInPlaceDescriptor& update_descriptor);
+   };
+   // -------------------------------------------------------------------------------------
+  private:
+   const u64 batch_id;
+   std::vector<TX> txs;
+   std::vector<std::vector<u64>> partitions;  // partition per worker: indexes into txs in ascending order
+
+  public:
+   DeterministicBatch(u64 batch_id) : batch_id(batch_id) {}
+   // Returns the position of the transaction in the serial order
+   u64 add(TX tx);
+   u64 size() const { return txs.size(); }
+   u64 batchID() const { return batch_id; }
+   // -------------------------------------------------------------------------------------
+   // Deterministic: the same batch and workers_count always give the same partitions
+   void plan(u64 workers_count);
+   const std::vector<u64>& partition(u64 w_i) const { return partitions[w_i]; }
+   // Called by worker w_i after plan()
+   void executePartition(u64 w_i, TX_DURABILITY durability);
+};
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
@@ -1,4 +1,5 @@
 #include "CRMG.hpp"
+#include "GroupCommitPacer.hpp"
 #include "leanstore/profiling/counters/CPUCounters.hpp"
 #include "leanstore/profiling/counters/CRCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
@@ -12,6 +13,7 @@
 #include <chrono>
 #include <cstring>
 #include <thread>
+#include <tuple>
 // -------------------------------------------------------------------------------------
 using namespace std::chrono_literals;
 namespace leanstore
@@ -30,16 +32,44 @@ void CRManager::groupCommitCordinator()
       LID min_all_workers_gsn;  // For Remote Flush Avoidance
       LID max_all_workers_gsn;  // Sync all workers to this point
       TXID min_all_workers_hardened_commit_ts;
+      // -------------------------------------------------------------------------------------
+      // Log writers wait for 3 fsync rounds after their write before they harden it, and hardened values need one more round
+      // to get published, so keep going that long after the last change in any worker WAL or hardened state
+      constexpr u64 ROUNDS_AFTER_LAST_ARRIVAL = 4;
+      u64 rounds_since_last_arrival = 0;
+      std::vector<std::tuple<u64, LID, TXID>> last_seen(workers_count);
+      GroupCommitPacer pacer;
+      auto probe_backlog = [&]() {
+         GroupCommitPacer::Backlog backlog;
+         for (WORKERID w_i = 0; w_i < workers_count; w_i++) {
+            Worker& worker = *workers[w_i];
+            const auto seen =
+                std::make_tuple(worker.logging.wt_to_lw.optimistic_latch.load(), worker.logging.hardened_gsn.load(), worker.logging.hardened_commit_ts.load());
+            if (seen != last_seen[w_i]) {
+               last_seen[w_i] = seen;
+               rounds_since_last_arrival = 0;
+            }
+         }
+         backlog.urgent = (rounds_since_last_arrival < ROUNDS_AFTER_LAST_ARRIVAL);
+         return backlog;
+      };
+      // -------------------------------------------------------------------------------------
       while (keep_running) {
+         const GroupCommitPacer::Backlog backlog = pacer.waitForRound(keep_running, probe_backlog);
+         rounds_since_last_arrival++;
+         const auto flush_begin = std::chrono::high_resolution_clock::now();
+         // -------------------------------------------------------------------------------------
          min_all_workers_gsn = std::numeric_limits<LID>::max();
          max_all_workers_gsn = 0;
          min_all_workers_hardened_commit_ts = std::numeric_limits<TXID>::max();
          // -------------------------------------------------------------------------------------
          if (FLAGS_wal_fsync) {
-            fdatasync(ssd_fd);
+            wal_device.sync();
          }
          fsync_counter++;
          fsync_counter.notify_all();
+         pacer.roundDone(backlog, 0,
+                         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - flush_begin).count());
          // -------------------------------------------------------------------------------------
          for (WORKERID w_i = 0; w_i < workers_count; w_i++) {
             Worker& worker = *workers[w_i];
@@ -48,10 +78,13 @@ void CRManager::groupCommitCordinator()
             min_all_workers_hardened_commit_ts = std::min<TXID>(min_all_workers_hardened_commit_ts, worker.logging.hardened_commit_ts);
          }
          // -------------------------------------------------------------------------------------
-         assert(Worker::Logging::global_min_gsn_flushed.load() <= min_all_workers_gsn);
-         Worker::Logging::global_min_commit_ts_flushed.store(min_all_workers_hardened_commit_ts, std::memory_order_release);
-         Worker::Logging::global_min_gsn_flushed.store(min_all_workers_gsn, std::memory_order_release);
-         Worker::Logging::global_sync_to_this_gsn.store(max_all_workers_gsn, std::memory_order_release);
+         assert(workers_global.min_gsn_flushed.load() <= min_all_workers_gsn);
+         workers_global.min_commit_ts_flushed.store(min_all_workers_hardened_commit_ts, std::memory_order_release);
+         workers_global.min_gsn_flushed.store(min_all_workers_gsn, std::memory_order_release);
+         workers_global.sync_to_this_gsn.store(max_all_workers_gsn, std::memory_order_release);
+         for (WORKERID w_i = 0; w_i < workers_count; w_i++) {
+            workers[w_i]->logging.wakeUpSyncCommit();  // Waiting SYNC commits pick up the new sync point
+         }
          // -------------------------------------------------------------------------------------
          CRCounters::myCounters().gct_rounds += 1;
       }
@@ -0,0 +1,134 @@
+#pragma once
+#include "Exceptions.hpp"
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/profiling/counters/CRCounters.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace cr
+{
+// -------------------------------------------------------------------------------------
+// Decides when the group committer starts its next round instead of looping as fast as possible
+// Idle: nothing arrived since the previous round, park with exponential back-off up to FLAGS_wal_max_park_us
+// Lazy: only WAL of transactions nobody waits for (ASYNC, NON_DURABLE, still running), flush it within FLAGS_wal_max_park_us
+// Urgent: a SYNC commit waits, start the round right away
+// Busy: with FLAGS_wal_commit_latency_target_us, hold the round back to gather a bigger flush batch as long as
+// (1) the oldest waiting transaction still meets the target given the observed flush latency,
+// (2) the observed arrival rate predicts at least one more transaction within the remaining budget,
+// (3) no worker WAL buffer is expected to get more than half full meanwhile
+class GroupCommitPacer
+{
+  public:
+   struct Backlog {
+      u64 pending_tx = 0;        // Pre-committed transactions waiting in the queues
+      u64 pending_bytes = 0;     // WAL bytes the workers wrote but the group committer did not pick up yet
+      u64 max_worker_bytes = 0;  // Largest pending_bytes share of a single worker
+      bool urgent = false;       // Somebody blocks until the next round is done
+   };
+
+  private:
+   using Clock = std::chrono::high_resolution_clock;
+   static constexpr double EWMA_ALPHA = 0.2;
+   static constexpr u64 MIN_SLEEP_US = 20;   // Below that, sleep_for overshoots more than it gains
+   static constexpr u64 MAX_SLEEP_US = 100;  // Re-probe at least that often while gathering to notice urgent commits
+   // -------------------------------------------------------------------------------------
+   double flush_us = 0;      // Write + fdatasync latency
+   double tx_per_us = 0;     // Arrival rate of pre-committed transactions
+   double bytes_per_us = 0;  // Arrival rate of WAL bytes per worker buffer
+   u64 park_us = 0;
+   u64 carried_tx = 0;  // Transactions the previous round left in the queues
+   Clock::time_point last_round_end = Clock::now();
+   // -------------------------------------------------------------------------------------
+   static void ewma(double& avg, double sample) { avg = (avg == 0) ? sample : (EWMA_ALPHA * sample + (1 - EWMA_ALPHA) * avg); }
+   static u64 microsecondsSince(Clock::time_point begin) { return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count(); }
+
+  public:
+   // Blocks until the caller should run its next round, probe() returns the current Backlog
+   // Returns the Backlog the decision was made on
+   template <typename Probe>
+   Backlog waitForRound(const std::atomic<bool>& keep_running, Probe probe)
+   {
+      Backlog backlog;
+      Clock::time_point gather_begin, lazy_begin;
+      bool gathering = false, lazy = false;
+      auto park = [&]() {
+         park_us = std::clamp<u64>(park_us * 2, 1, FLAGS_wal_max_park_us);
+         std::this_thread::sleep_for(std::chrono::microseconds(park_us));
+         COUNTERS_BLOCK() { CRCounters::myCounters().gct_parked_ms += park_us; }
+      };
+      while (keep_running) {
+         backlog = probe();
+         if (backlog.urgent) {
+            break;
+         }
+         if (backlog.pending_tx <= carried_tx) {
+            if (FLAGS_wal_max_park_us == 0) {
+               return backlog;
+            }
+            if (backlog.pending_bytes == 0) {
+               lazy = false;
+               park();
+               continue;
+            }
+            if (!lazy) {
+               lazy = true;
+               lazy_begin = Clock::now();
+            }
+            if (microsecondsSince(lazy_begin) < FLAGS_wal_max_park_us && backlog.max_worker_bytes < FLAGS_wal_buffer_size / 2) {
+               park();
+               continue;
+            }
+            break;
+         }
+         park_us = 0;
+         if (FLAGS_wal_commit_latency_target_us == 0) {
+            return backlog;
+         }
+         // -------------------------------------------------------------------------------------
+         if (!gathering) {
+            gathering = true;
+            gather_begin = Clock::now();
+         }
+         const double budget_us = double(FLAGS_wal_commit_latency_target_us) - flush_us - microsecondsSince(gather_begin);
+         if (budget_us < MIN_SLEEP_US || tx_per_us * budget_us < 1.0) {
+            break;
+         }
+         const double free_bytes = (FLAGS_wal_buffer_size / 2.0) - backlog.max_worker_bytes;
+         if (free_bytes <= 0) {
+            break;
+         }
+         const double sleep_us = std::min<double>((bytes_per_us > 0) ? std::min(budget_us, free_bytes / bytes_per_us) : budget_us, MAX_SLEEP_US);
+         if (sleep_us < MIN_SLEEP_US) {
+            break;
+         }
+         std::this_thread::sleep_for(std::chrono::microseconds(u64(sleep_us)));
+      }
+      park_us = 0;
+      if (gathering) {
+         COUNTERS_BLOCK() { CRCounters::myCounters().gct_gather_ms += microsecondsSince(gather_begin); }
+      }
+      return backlog;
+   }
+   // -------------------------------------------------------------------------------------
+   // backlog: what waitForRound returned, committed_tx: how many of them the round signaled
+   void roundDone(const Backlog& backlog, u64 committed_tx, u64 round_flush_us)
+   {
+      const u64 elapsed_us = std::max<u64>(microsecondsSince(last_round_end), 1);
+      const u64 arrived_tx = (backlog.pending_tx > carried_tx) ? backlog.pending_tx - carried_tx : 0;
+      ewma(tx_per_us, double(arrived_tx) / elapsed_us);
+      ewma(bytes_per_us, double(backlog.max_worker_bytes) / elapsed_us);
+      ewma(flush_us, round_flush_us);
+      carried_tx = (backlog.pending_tx > committed_tx) ? backlog.pending_tx - committed_tx : 0;
+      last_round_end = Clock::now();
+   }
+};
+// -------------------------------------------------------------------------------------
+}  // namespace cr
+}  // namespace leanstore
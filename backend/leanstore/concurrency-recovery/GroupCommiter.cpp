@@ -1,11 +1,11 @@
 #include "CRMG.hpp"
+#include "GroupCommitPacer.hpp"
 #include "leanstore/profiling/counters/CPUCounters.hpp"
 #include "leanstore/profiling/counters/CRCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
 #include "leanstore/utils/Misc.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
-#include <libaio.h>
 #include <unistd.h>
 
 #include <chrono>
@@ -34,24 +34,13 @@ void CRManager::groupCommiter()
    // Async IO
    const u64 batch_max_size = (workers_count * 2) + 2;  // 2x because of potential wrapping around
    s32 io_slot = 0;
-   std::unique_ptr<struct iocb[]> iocbs = make_unique<struct iocb[]>(batch_max_size);
-   std::unique_ptr<struct iocb*[]> iocbs_ptr = make_unique<struct iocb*[]>(batch_max_size);
-   std::unique_ptr<struct io_event[]> events = make_unique<struct io_event[]>(batch_max_size);
-   io_context_t aio_context;
-   {
-      memset(&aio_context, 0, sizeof(aio_context));
-      const int ret = io_setup(batch_max_size, &aio_context);
-      if (ret != 0) {
-         throw ex::GenericException("io_setup failed, ret code = " + std::to_string(ret));
-      }
-   }
+   std::unique_ptr<storage::io::AsyncIO> aio = wal_device.createAsyncIO(batch_max_size);
+   std::unique_ptr<storage::io::IOEvent[]> events = make_unique<storage::io::IOEvent[]>(batch_max_size);
    auto add_pwrite = [&](u8* src, u64 size, u64 offset) {
       ensure(offset % 512 == 0);
       ensure(u64(src) % 512 == 0);
       ensure(size % 512 == 0);
-      io_prep_pwrite(&iocbs[io_slot], ssd_fd, src, size, offset);
-      iocbs[io_slot].data = src;
-      iocbs_ptr[io_slot] = &iocbs[io_slot];
+      aio->prepWrite(src, size, offset, src);
       io_slot++;
    };
    // -------------------------------------------------------------------------------------
@@ -63,7 +52,24 @@ void CRManager::groupCommiter()
    ready_to_commit_rfa_cut.resize(workers_count, 0);
    wt_to_lw_copy.resize(workers_count);
    // -------------------------------------------------------------------------------------
+   GroupCommitPacer pacer;
+   auto probe_backlog = [&]() {
+      GroupCommitPacer::Backlog backlog;
+      for (u32 w_i = 0; w_i < workers_count; w_i++) {
+         Worker& worker = *workers[w_i];
+         const u64 written_offset = worker.logging.wt_to_lw.getSync().wal_written_offset;
+         const u64 gct_cursor = worker.logging.wal_gct_cursor;
+         const u64 worker_bytes = (written_offset >= gct_cursor) ? written_offset - gct_cursor : FLAGS_wal_buffer_size - gct_cursor + written_offset;
+         backlog.pending_bytes += worker_bytes;
+         backlog.max_worker_bytes = std::max<u64>(backlog.max_worker_bytes, worker_bytes);
+         backlog.pending_tx += worker.logging.precommitted_queue.size() + worker.logging.precommitted_queue_rfa.size();
+         backlog.urgent |= (worker.logging.sync_commit_ts.load() != 0);
+      }
+      return backlog;
+   };
+   // -------------------------------------------------------------------------------------
    while (keep_running) {
+      const GroupCommitPacer::Backlog backlog = pacer.waitForRound(keep_running, probe_backlog);
       io_slot = 0;
       round_i++;
       CRCounters::myCounters().gct_rounds++;
@@ -77,10 +83,7 @@ void CRManager::groupCommiter()
       for (u32 w_i = 0; w_i < workers_count; w_i++) {
          Worker& worker = *workers[w_i];
          {
-            {
-               std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
-               ready_to_commit_rfa_cut[w_i] = worker.logging.precommitted_queue_rfa.size();
-            }
+            ready_to_commit_rfa_cut[w_i] = worker.logging.precommitted_queue_rfa.size();
             wt_to_lw_copy[w_i] = worker.logging.wt_to_lw.getSync();
             // -------------------------------------------------------------------------------------
             max_all_workers_gsn = std::max<LID>(max_all_workers_gsn, wt_to_lw_copy[w_i].last_gsn);
@@ -137,32 +140,21 @@ void CRManager::groupCommiter()
       }
       // -------------------------------------------------------------------------------------
       // Flush
+      const auto flush_begin = std::chrono::high_resolution_clock::now();
       if (FLAGS_wal_pwrite) {
          ensure(ssd_offset % 512 == 0);
          if (FLAGS_wal_pwrite) {
-            u32 submitted = 0;
-            u32 left = io_slot;
-            while (left) {
-               s32 ret_code = io_submit(aio_context, left, iocbs_ptr.get() + submitted);
-               if (ret_code != s32(io_slot)) {
-                  cout << ret_code << "," << io_slot << "," << ssd_offset << endl;
-                  ensure(false);
-               }
-               posix_check(ret_code >= 0);
-               submitted += ret_code;
-               left -= ret_code;
-            }
-            {
-               if (io_slot > 0) {
-                  const s32 done_requests = io_getevents(aio_context, submitted, submitted, events.get(), NULL);
-                  posix_check(done_requests >= 0);
-               }
+            const u64 submitted = aio->submit();
+            ensure(submitted == u64(io_slot));
+            if (submitted > 0) {
+               aio->poll(submitted, submitted, events.get());
             }
             if (FLAGS_wal_fsync) {
-               fdatasync(ssd_fd);
+               wal_device.sync();
             }
          }
       }
+      const u64 flush_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - flush_begin).count();
       // -------------------------------------------------------------------------------------
       COUNTERS_BLOCK()
       {
@@ -176,39 +168,35 @@ void CRManager::groupCommiter()
          Worker& worker = *workers[w_i];
          worker.logging.hardened_commit_ts.store(wt_to_lw_copy[w_i].precommitted_tx_commit_ts, std::memory_order_release);
          TXID signaled_up_to = std::numeric_limits<TXID>::max();
-         // TODO: prevent contention on mutex
          {
             worker.logging.wal_gct_cursor.store(wt_to_lw_copy[w_i].wal_written_offset, std::memory_order_release);
-            std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
             // -------------------------------------------------------------------------------------
+            auto& precommitted_queue = worker.logging.precommitted_queue;
+            const u64 precommitted_count = precommitted_queue.size();
             u64 tx_i = 0;
-            for (tx_i = 0;
-                 tx_i < worker.logging.precommitted_queue.size() && worker.logging.precommitted_queue[tx_i].max_observed_gsn <= min_all_workers_gsn &&
-                 worker.logging.precommitted_queue[tx_i].start_ts <= min_all_workers_hardened_commit_ts;
+            for (tx_i = 0; tx_i < precommitted_count && precommitted_queue.at(tx_i).max_observed_gsn <= min_all_workers_gsn &&
+                           precommitted_queue.at(tx_i).start_ts <= min_all_workers_hardened_commit_ts;
                  tx_i++) {
-               worker.logging.precommitted_queue[tx_i].state = Transaction::STATE::COMMITTED;
             }
             if (tx_i > 0) {
-               signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue[tx_i - 1].commitTS());
-               worker.logging.precommitted_queue.erase(worker.logging.precommitted_queue.begin(), worker.logging.precommitted_queue.begin() + tx_i);
+               signaled_up_to = std::min<TXID>(signaled_up_to, precommitted_queue.at(tx_i - 1).commit_ts);
+               precommitted_queue.popFront(tx_i);
                committed_tx += tx_i;
             }
             // -------------------------------------------------------------------------------------
-            for (tx_i = 0; tx_i < ready_to_commit_rfa_cut[w_i]; tx_i++) {
-               worker.logging.precommitted_queue_rfa[tx_i].state = Transaction::STATE::COMMITTED;
-            }
+            tx_i = ready_to_commit_rfa_cut[w_i];
             if (tx_i > 0) {
-               signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa[tx_i - 1].commitTS());
-               worker.logging.precommitted_queue_rfa.erase(worker.logging.precommitted_queue_rfa.begin(),
-                                                           worker.logging.precommitted_queue_rfa.begin() + tx_i);
+               signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa.at(tx_i - 1).commit_ts);
+               worker.logging.precommitted_queue_rfa.popFront(tx_i);
                committed_tx += tx_i;
             }
          }
          if (signaled_up_to < std::numeric_limits<TXID>::max() && signaled_up_to > 0) {
-            worker.logging.signaled_commit_ts.store(signaled_up_to, std::memory_order_release);
+            worker.logging.signalCommitted(signaled_up_to);
          }
       }
       CRCounters::myCounters().gct_committed_tx += committed_tx;
+      pacer.roundDone(backlog, committed_tx, flush_us);
       COUNTERS_BLOCK()
       {
          phase_2_end = std::chrono::high_resolution_clock::now();
@@ -217,9 +205,13 @@ void CRManager::groupCommiter()
          CRCounters::myCounters().gct_write_ms += (std::chrono::duration_cast<std::chrono::microseconds>(write_end - write_begin).count());
       }
       // -------------------------------------------------------------------------------------
-      assert(Worker::Logging::global_min_gsn_flushed.load() <= min_all_workers_gsn);
-      Worker::Logging::global_min_gsn_flushed.store(min_all_workers_gsn, std::memory_order_release);
-      Worker::Logging::global_sync_to_this_gsn.store(max_all_workers_gsn, std::memory_order_release);
+      assert(workers_global.min_gsn_flushed.load() <= min_all_workers_gsn);
+      workers_global.min_gsn_flushed.store(min_all_workers_gsn, std::memory_order_release);
+      workers_global.sync_to_this_gsn.store(max_all_workers_gsn, std::memory_order_release);
+      workers_global.gct_rounds.fetch_add(1, std::memory_order_release);
+      for (u32 w_i = 0; w_i < workers_count; w_i++) {
+         workers[w_i]->logging.wakeUpSyncCommit();  // They wait for a signal or for this round
+      }
    }
    running_threads--;
 }
@@ -6,7 +6,6 @@
 #include "leanstore/utils/Parallelize.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
-#include <libaio.h>
 #include <unistd.h>
 
 #include <chrono>
@@ -32,32 +31,33 @@ void CRManager::groupCommiter2()
          for (WORKERID w_i = 0; w_i < workers_count; w_i++) {
             Worker& worker = *workers[w_i];
             const auto time_now = std::chrono::high_resolution_clock::now();
-            std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
             // -------------------------------------------------------------------------------------
+            const u64 precommitted_count = worker.logging.precommitted_queue.size();
             u64 tx_i = 0;
             TXID signaled_up_to = std::numeric_limits<TXID>::max();
-            for (tx_i = 0; tx_i < worker.logging.precommitted_queue.size(); tx_i++) {
-               auto& tx = worker.logging.precommitted_queue[tx_i];
-               if (tx.max_observed_gsn > Worker::Logging::global_min_gsn_flushed || tx.start_ts > Worker::Logging::global_min_commit_ts_flushed) {
-                  tx.stats.flushes_counter++;
+            for (tx_i = 0; tx_i < precommitted_count; tx_i++) {
+               auto& tx = worker.logging.precommitted_queue.at(tx_i);
+               if (tx.max_observed_gsn > workers_global.min_gsn_flushed || tx.start_ts > workers_global.min_commit_ts_flushed) {
+                  tx.flushes_counter++;
                   break;
                }
-               tx.state = Transaction::STATE::COMMITTED;
-               tx.stats.commit = time_now;
                if (1) {
                   const u64 cursor = CRCounters::myCounters().cc_latency_cursor++ % CRCounters::latency_tx_capacity;
                   CRCounters::myCounters().cc_ms_precommit_latency[cursor] =
-                      std::chrono::duration_cast<std::chrono::microseconds>(tx.stats.precommit - tx.stats.start).count();
+                      std::chrono::duration_cast<std::chrono::microseconds>(tx.precommit - tx.start).count();
                   CRCounters::myCounters().cc_ms_commit_latency[cursor] =
-                      std::chrono::duration_cast<std::chrono::microseconds>(tx.stats.commit - tx.stats.start).count();
-                  CRCounters::myCounters().cc_flushes_counter[cursor] += tx.stats.flushes_counter;
+                      std::chrono::duration_cast<std::chrono::microseconds>(time_now - tx.start).count();
+                  CRCounters::myCounters().cc_flushes_counter[cursor] += tx.flushes_counter;
                }
             }
             if (tx_i > 0) {
-               signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue[tx_i - 1].commitTS());
-               worker.logging.precommitted_queue.erase(worker.logging.precommitted_queue.begin(), worker.logging.precommitted_queue.begin() + tx_i);
+               signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue.at(tx_i - 1).commit_ts);
+               worker.logging.precommitted_queue.popFront(tx_i);
                committed_tx += tx_i;
             }
+            if (signaled_up_to < std::numeric_limits<TXID>::max() && signaled_up_to > 0) {
+               worker.logging.signalCommitted(signaled_up_to);
+            }
          }
          // -------------------------------------------------------------------------------------
          // CRCounters::myCounters().gct_rounds += 1;
@@ -92,10 +92,7 @@ void CRManager::groupCommiter2()
             {
                Worker& worker = *workers[w_i];
                {
-                  {
-                     std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
-                     ready_to_commit_rfa_cut[0] = worker.logging.precommitted_queue_rfa.size();
-                  }
+                  ready_to_commit_rfa_cut[0] = worker.logging.precommitted_queue_rfa.size();
                   wt_to_lw_copy[0] = worker.logging.wt_to_lw.getSync();
                }
                if (wt_to_lw_copy[0].wal_written_offset > worker.logging.wal_gct_cursor) {
@@ -106,7 +103,7 @@ void CRManager::groupCommiter2()
                   if (FLAGS_wal_pwrite) {
                      // TODO: add the concept of chunks
                      const u64 ssd_offset = g_ssd_offset.fetch_add(-size_aligned) - size_aligned;
-                     pwrite(ssd_fd, worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
+                     wal_device.write(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                      // add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                      // -------------------------------------------------------------------------------------
                      COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
@@ -120,7 +117,7 @@ void CRManager::groupCommiter2()
                      // -------------------------------------------------------------------------------------
                      if (FLAGS_wal_pwrite) {
                         const u64 ssd_offset = g_ssd_offset.fetch_add(-size_aligned) - size_aligned;
-                        pwrite(ssd_fd, worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
+                        wal_device.write(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                         // add_pwrite(worker.logging.wal_buffer + lower_offset, size_aligned, ssd_offset);
                         // -------------------------------------------------------------------------------------
                         COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
@@ -134,7 +131,7 @@ void CRManager::groupCommiter2()
                      // -------------------------------------------------------------------------------------
                      if (FLAGS_wal_pwrite) {
                         const u64 ssd_offset = g_ssd_offset.fetch_add(-size_aligned) - size_aligned;
-                        pwrite(ssd_fd, worker.logging.wal_buffer, size_aligned, ssd_offset);
+                        wal_device.write(worker.logging.wal_buffer, size_aligned, ssd_offset);
                         // add_pwrite(worker.logging.wal_buffer, size_aligned, ssd_offset);
                         // -------------------------------------------------------------------------------------
                         COUNTERS_BLOCK() { CRCounters::myCounters().gct_write_bytes += size_aligned; }
@@ -163,35 +160,30 @@ void CRManager::groupCommiter2()
                worker.logging.hardened_commit_ts.store(wt_to_lw_copy[0].precommitted_tx_commit_ts, std::memory_order_release);
                worker.logging.hardened_gsn.store(wt_to_lw_copy[0].last_gsn, std::memory_order_release);
                TXID signaled_up_to = std::numeric_limits<TXID>::max();
-               // TODO: prevent contention on mutex
                {
                   worker.logging.wal_gct_cursor.store(wt_to_lw_copy[0].wal_written_offset, std::memory_order_release);
                   const auto time_now = std::chrono::high_resolution_clock::now();
-                  std::unique_lock<std::mutex> g(worker.logging.precommitted_queue_mutex);
                   // -------------------------------------------------------------------------------------
                   // RFA
                   u64 tx_i = 0;
                   for (tx_i = 0; tx_i < ready_to_commit_rfa_cut[0]; tx_i++) {
-                     auto& tx = worker.logging.precommitted_queue_rfa[tx_i];
-                     tx.state = Transaction::STATE::COMMITTED;
-                     tx.stats.commit = time_now;
+                     auto& tx = worker.logging.precommitted_queue_rfa.at(tx_i);
                      if (1) {
                         const u64 cursor = CRCounters::myCounters().cc_rfa_latency_cursor++ % CRCounters::latency_tx_capacity;
                         CRCounters::myCounters().cc_rfa_ms_precommit_latency[cursor] =
-                            std::chrono::duration_cast<std::chrono::microseconds>(tx.stats.precommit - tx.stats.start).count();
+                            std::chrono::duration_cast<std::chrono::microseconds>(tx.precommit - tx.start).count();
                         CRCounters::myCounters().cc_rfa_ms_commit_latency[cursor] =
-                            std::chrono::duration_cast<std::chrono::microseconds>(tx.stats.commit - tx.stats.start).count();
+                            std::chrono::duration_cast<std::chrono::microseconds>(time_now - tx.start).count();
                      }
                   }
                   if (tx_i > 0) {
-                     signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa[tx_i - 1].commitTS());
-                     worker.logging.precommitted_queue_rfa.erase(worker.logging.precommitted_queue_rfa.begin(),
-                                                                 worker.logging.precommitted_queue_rfa.begin() + tx_i);
+                     signaled_up_to = std::min<TXID>(signaled_up_to, worker.logging.precommitted_queue_rfa.at(tx_i - 1).commit_ts);
+                     worker.logging.precommitted_queue_rfa.popFront(tx_i);
                      committed_tx += tx_i;
                   }
                }
                if (signaled_up_to < std::numeric_limits<TXID>::max() && signaled_up_to > 0) {
-                  worker.logging.signaled_commit_ts.store(signaled_up_to, std::memory_order_release);
+                  worker.logging.signalCommitted(signaled_up_to);
                }
             }
             CRCounters::myCounters().gct_committed_tx += committed_tx;
@@ -11,9 +11,23 @@ namespace leanstore
 namespace cr
 {
 // -------------------------------------------------------------------------------------
-atomic<u64> Worker::Logging::global_min_gsn_flushed = 0;
-atomic<u64> Worker::Logging::global_min_commit_ts_flushed = 0;
-atomic<u64> Worker::Logging::global_sync_to_this_gsn = 0;
+// Signaled commit ts only moves forward, even when the RFA and the remote flush queue are drained by different threads
+void Worker::Logging::signalCommitted(TXID commit_ts)
+{
+   TXID current = signaled_commit_ts.load();
+   while (current < commit_ts && !signaled_commit_ts.compare_exchange_weak(current, commit_ts)) {
+   }
+   wakeUpSyncCommit();
+}
+// -------------------------------------------------------------------------------------
+// Futex-style wake up of a SYNC commit that stopped spinning, a no-op unless one waits
+void Worker::Logging::wakeUpSyncCommit()
+{
+   if (sync_commit_ts.load() != 0) {
+      sync_wakeups.fetch_add(1);
+      sync_wakeups.notify_all();
+   }
+}
 // -------------------------------------------------------------------------------------
 u32 Worker::Logging::walFreeSpace()
 {
@@ -36,7 +50,8 @@ u32 Worker::Logging::walContiguousFreeSpace()
 // -------------------------------------------------------------------------------------
 void Worker::Logging::walEnsureEnoughSpace(u32 requested_size)
 {
-   if (FLAGS_wal) {
+   PROFILE_REGION(RegionCounters::WAL_APPEND, false);
+   if (FLAGS_wal && my().active_tx.isDurable()) {
       u32 wait_untill_free_bytes = requested_size + CR_ENTRY_SIZE;
       if ((FLAGS_wal_buffer_size - wal_wt_cursor) < static_cast<u32>(requested_size + CR_ENTRY_SIZE)) {
          wait_untill_free_bytes += FLAGS_wal_buffer_size - wal_wt_cursor;  // we have to skip this round
@@ -92,8 +107,44 @@ void Worker::Logging::submitWALMetaEntry()
    wt_to_lw.pushSync(current);
 }
 // -------------------------------------------------------------------------------------
+WALBatchInputEntry& Worker::Logging::reserveWALBatchInputEntry(u16 input_length)
+{
+   const u64 total_size = sizeof(WALBatchInputEntry) + input_length;
+   ensure(total_size <= std::numeric_limits<u16>::max());
+   walEnsureEnoughSpace(total_size);
+   active_bi_entry = new (wal_buffer + wal_wt_cursor) WALBatchInputEntry();
+   active_bi_entry->lsn.store(wal_lsn_counter++, std::memory_order_release);
+   active_bi_entry->magic_debugging_number = 99;
+   active_bi_entry->type = WALEntry::TYPE::BATCH_INPUT;
+   active_bi_entry->size = total_size;
+   active_bi_entry->input_length = input_length;
+   return *active_bi_entry;
+}
+// -------------------------------------------------------------------------------------
+void Worker::Logging::submitWALBatchInputEntry()
+{
+   const u64 total_size = active_bi_entry->size;
+   if (!((wal_wt_cursor >= current_tx_wal_start) || (wal_wt_cursor + total_size < current_tx_wal_start))) {
+      my().active_tx.wal_larger_than_buffer = true;
+   }
+   DEBUG_BLOCK()
+   {
+      active_bi_entry->computeCRC();
+   }
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().wal_write_bytes += total_size;
+   }
+   wal_wt_cursor += total_size;
+   publishOffset();
+}
+// -------------------------------------------------------------------------------------
 void Worker::Logging::submitDTEntry(u64 total_size)
 {
+   PROFILE_REGION(RegionCounters::WAL_APPEND, false);
+   if (!my().active_tx.isDurable()) {
+      return;  // Already in the undo buffer
+   }
    if(!((wal_wt_cursor >= current_tx_wal_start) || (wal_wt_cursor + total_size  < current_tx_wal_start))) {
       my().active_tx.wal_larger_than_buffer = true;
    }
@@ -130,5 +181,20 @@ void Worker::Logging::iterateOverCurrentTXEntries(std::function<void(const WALEn
    }
 }
 // -------------------------------------------------------------------------------------
+void Worker::Logging::moveUndoBufferToWAL()
+{
+   assert(my().active_tx.isDurable());
+   for (u64 offset = 0; offset < undo_buffer.size();) {
+      const u64 total_size = reinterpret_cast<const WALEntry*>(undo_buffer.data() + offset)->size;
+      walEnsureEnoughSpace(total_size);
+      std::memcpy(wal_buffer + wal_wt_cursor, undo_buffer.data() + offset, total_size);
+      active_dt_entry = reinterpret_cast<WALDTEntry*>(wal_buffer + wal_wt_cursor);
+      active_dt_entry->lsn.store(wal_lsn_counter++, std::memory_order_release);
+      submitDTEntry(total_size);
+      offset += total_size;
+   }
+   undo_buffer.clear();
+}
+// -------------------------------------------------------------------------------------
 }  // namespace cr
 }  // namespace leanstore
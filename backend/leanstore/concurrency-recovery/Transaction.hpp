@@ -9,6 +9,11 @@ namespace leanstore
 {
 enum class TX_MODE : u8 { OLAP, OLTP, DETERMINISTIC, INSTANTLY_VISIBLE_BULK_INSERT };
 enum class TX_ISOLATION_LEVEL : u8 { SERIALIZABLE = 3, SNAPSHOT_ISOLATION = 2, READ_COMMITTED = 1, READ_UNCOMMITTED = 0 };
+// NON_DURABLE: writes no WAL, the DT entries stay in an in-memory undo buffer for aborts, changes may be lost on crash
+// ASYNC: acknowledged at precommit, its WAL is flushed lazily with the next group commit round
+// GROUP: acknowledged at precommit, signaled once the group committer hardened it (default)
+// SYNC: commitTX blocks until the group committer hardened it, forces a round without batching delay
+enum class TX_DURABILITY : u8 { NON_DURABLE = 0, ASYNC = 1, GROUP = 2, SYNC = 3 };
 inline TX_ISOLATION_LEVEL parseIsolationLevel(std::string str)
 {
    if (str == "ser") {
@@ -37,8 +42,8 @@ struct Transaction {
    LID min_observed_gsn_when_started, max_observed_gsn;
    TX_MODE current_tx_mode = TX_MODE::OLTP;
    TX_ISOLATION_LEVEL current_tx_isolation_level = TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION;
-   bool is_durable = false;
-   bool can_use_single_version_mode = false;
+   TX_DURABILITY durability = TX_DURABILITY::GROUP;
+   bool can_use_single_version_mode = false;  // Updates may skip the history version (FLAGS_vi_update_version_elision)
    bool safe_snapshot = false;
    bool is_read_only = false;
    bool has_wrote = false;
@@ -53,7 +58,8 @@ struct Transaction {
    bool isOLTP() { return current_tx_mode == TX_MODE::OLTP; }
    bool isReadOnly() { return is_read_only; }
    bool hasWrote() { return has_wrote; }
-   bool isDurable() { return is_durable; }
+   bool isDurable() { return durability != TX_DURABILITY::NON_DURABLE; }
+   bool waitsForGroupCommit() { return durability >= TX_DURABILITY::GROUP; }
    bool atLeastSI() { return current_tx_isolation_level >= TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION; }
    bool isSI() { return current_tx_isolation_level == TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION; }
    bool isReadCommitted() { return current_tx_isolation_level == TX_ISOLATION_LEVEL::READ_COMMITTED; }
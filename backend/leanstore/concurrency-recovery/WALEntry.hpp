@@ -12,7 +12,7 @@ namespace cr
 {
 // -------------------------------------------------------------------------------------
 struct WALEntry {
-   enum class TYPE : u8 { TX_START, TX_COMMIT, TX_ABORT, DT_SPECIFIC, CARRIAGE_RETURN };
+   enum class TYPE : u8 { TX_START, TX_COMMIT, TX_ABORT, DT_SPECIFIC, CARRIAGE_RETURN, BATCH_INPUT };
    // -------------------------------------------------------------------------------------
    u64 magic_debugging_number = 99;
    std::atomic<LID> lsn;
@@ -39,5 +39,14 @@ struct WALDTEntry : WALEntry {
    u8 payload[];
 };
 // -------------------------------------------------------------------------------------
+// Input of one transaction of a deterministic batch, its data changes are not logged
+// Replaying all inputs of a batch in (batch_id, tx_i) order re-executes it
+struct WALBatchInputEntry : WALEntry {
+   u64 batch_id;
+   u32 tx_i;
+   u16 input_length;
+   u8 payload[];
+};
+// -------------------------------------------------------------------------------------
 }  // namespace cr
 }  // namespace leanstore
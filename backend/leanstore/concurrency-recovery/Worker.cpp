@@ -2,7 +2,7 @@
 
 #include "leanstore/Config.hpp"
 #include "leanstore/profiling/counters/CRCounters.hpp"
-#include "leanstore/storage/buffer-manager/DTRegistry.hpp"
+#include "leanstore/storage/buffer-manager/BufferManager.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 #include <stdio.h>
@@ -13,6 +13,7 @@
 #include <fstream>
 #include <mutex>
 #include <sstream>
+#include <thread>
 // -------------------------------------------------------------------------------------
 namespace leanstore
 {
@@ -20,21 +21,18 @@ namespace cr
 {
 // -------------------------------------------------------------------------------------
 thread_local Worker* Worker::tls_ptr = nullptr;
-std::shared_mutex Worker::global_mutex;  // Unused
 // -------------------------------------------------------------------------------------
-std::unique_ptr<atomic<u64>[]> Worker::global_workers_current_snapshot;  // All transactions < are committed
-atomic<u64> Worker::global_oldest_all_start_ts = 0;
-atomic<u64> Worker::global_oldest_oltp_start_ts = 0;
-atomic<u64> Worker::global_all_lwm = 0;
-atomic<u64> Worker::global_oltp_lwm = 0;
-atomic<u64> Worker::global_newest_olap_start_ts = 0;
-// -------------------------------------------------------------------------------------
-Worker::Worker(u64 worker_id, Worker** all_workers, u64 workers_count, HistoryTreeInterface& history_tree, s32 fd, const bool is_page_provider)
-    : cc(history_tree, workers_count),
+Worker::Worker(u64 worker_id,
+               Worker** all_workers,
+               u64 workers_count,
+               Global& global,
+               HistoryTreeInterface& history_tree,
+               const bool is_page_provider)
+    : global(global),
+      cc(history_tree, workers_count),
       worker_id(worker_id),
       all_workers(all_workers),
       workers_count(workers_count),
-      ssd_fd(fd),
       is_page_provider(is_page_provider)
 {
    Worker::tls_ptr = this;
@@ -45,7 +43,7 @@ Worker::Worker(u64 worker_id, Worker** all_workers, u64 workers_count, HistoryTr
       cc.local_snapshot_cache = make_unique<u64[]>(workers_count);
       cc.local_snapshot_cache_ts = make_unique<u64[]>(workers_count);
       cc.local_workers_start_ts = make_unique<u64[]>(workers_count + 1);
-      global_workers_current_snapshot[worker_id] = 0;
+      global.workers_current_snapshot[worker_id] = 0;
    }
    cc.wt_pg.local_workers_tx_id = std::make_unique<std::atomic<TXID>[]>(workers_count);
 }
@@ -54,15 +52,20 @@ Worker::~Worker()
    delete[] cc.commit_tree.array;
 }
 // -------------------------------------------------------------------------------------
-void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_level, bool read_only)
+void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_level, bool read_only, TX_DURABILITY durability)
 {
+   if (FLAGS_bm_backpressure_us) {
+      storage::BMC::global_bf->applyBackpressure();
+   }
    utils::Timer timer(CRCounters::myCounters().cc_ms_start_tx);
    Transaction prev_tx = active_tx;
    active_tx.stats.start = std::chrono::high_resolution_clock::now();
    if (FLAGS_wal) {
+      active_tx.durability = durability;  // Decides where the WAL entries go from here on
       active_tx.wal_larger_than_buffer = false;
       logging.current_tx_wal_start = logging.wal_wt_cursor;
-      if (!read_only) {
+      logging.undo_buffer.clear();
+      if (!read_only && active_tx.isDurable()) {
          WALMetaEntry& entry = logging.reserveWALMetaEntry();
          entry.type = WALEntry::TYPE::TX_START;
          logging.submitWALMetaEntry();
@@ -70,13 +73,13 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
       }
       assert(prev_tx.state != Transaction::STATE::STARTED);
       // -------------------------------------------------------------------------------------
-      const LID sync_point = Worker::Logging::global_sync_to_this_gsn.load();
+      const LID sync_point = global.sync_to_this_gsn.load();
       if (sync_point > logging.getCurrentGSN()) {
          logging.setCurrentGSN(sync_point);
          logging.publishMaxGSNOffset();
       }
       if (FLAGS_wal_rfa) {
-         logging.rfa_gsn_flushed = Worker::Logging::global_min_gsn_flushed.load();
+         logging.rfa_gsn_flushed = global.min_gsn_flushed.load();
          logging.remote_flush_dependency = false;
       } else {
          logging.remote_flush_dependency = true;
@@ -88,7 +91,10 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
       active_tx.current_tx_mode = next_tx_type;
       active_tx.current_tx_isolation_level = next_tx_isolation_level;
       active_tx.is_read_only = read_only;
-      active_tx.is_durable = FLAGS_wal;  // TODO:
+      // No OLAP snapshot may be older than the OLTP ones, the per-update check against the LWM is in BTreeVI::updateSameSizeInPlaceAt
+      active_tx.can_use_single_version_mode = FLAGS_vi_update_version_elision && next_tx_type == TX_MODE::OLTP &&
+                                              next_tx_isolation_level >= TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION &&
+                                              global.oldest_oltp_start_ts == global.oldest_all_start_ts;
       // -------------------------------------------------------------------------------------
       // Draw TXID from global counter and publish it with the TX type (i.e., OLAP or OLTP)
       // We have to acquire a transaction id and use it for locking in ANY isolation level
@@ -99,16 +105,16 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
          // -------------------------------------------------------------------------------------
          {
            utils::Timer timer(CRCounters::myCounters().cc_ms_snapshotting);
-           global_workers_current_snapshot[worker_id].store(active_tx.start_ts | LATCH_BIT, std::memory_order_release);
-           active_tx.start_ts = ConcurrencyControl::global_clock.fetch_add(1);
+           global.workers_current_snapshot[worker_id].store(active_tx.start_ts | LATCH_BIT, std::memory_order_release);
+           active_tx.start_ts = global.clock.fetch_add(1);
            if (FLAGS_olap_mode) {
-             global_workers_current_snapshot[worker_id].store(active_tx.start_ts | ((active_tx.isOLAP()) ? OLAP_BIT : 0), std::memory_order_release);
+             global.workers_current_snapshot[worker_id].store(active_tx.start_ts | ((active_tx.isOLAP()) ? OLAP_BIT : 0), std::memory_order_release);
            } else {
-             global_workers_current_snapshot[worker_id].store(active_tx.start_ts, std::memory_order_release);
+             global.workers_current_snapshot[worker_id].store(active_tx.start_ts, std::memory_order_release);
            }
          }
          cc.commit_tree.cleanIfNecessary();
-         cc.local_global_all_lwm_cache = global_all_lwm.load();
+         cc.local_global_all_lwm_cache = global.all_lwm.load();
       } else {
         if (prev_tx.atLeastSI()) {
           cc.switchToReadCommittedMode();
@@ -118,9 +124,20 @@ void Worker::startTX(TX_MODE next_tx_type, TX_ISOLATION_LEVEL next_tx_isolation_
    }
 }
 // -------------------------------------------------------------------------------------
+void Worker::commitTX(TX_DURABILITY durability)
+{
+   const bool was_durable = active_tx.isDurable();
+   active_tx.durability = durability;
+   if (FLAGS_wal && !was_durable && active_tx.isDurable()) {
+      logging.moveUndoBufferToWAL();
+   }
+   commitTX();
+}
+// -------------------------------------------------------------------------------------
 void Worker::commitTX()
 {
-  if (activeTX().isDurable()) {
+  PROFILE_REGION(RegionCounters::COMMIT);
+  if (FLAGS_wal) {
     {
       utils::Timer timer(CRCounters::myCounters().cc_ms_commit_tx);
       command_id = 0;  // Reset command_id only on commit and never on abort
@@ -146,21 +163,61 @@ void Worker::commitTX()
       active_tx.max_observed_gsn = logging.wt_gsn_clock;
       active_tx.state = Transaction::STATE::READY_TO_COMMIT;
       // -------------------------------------------------------------------------------------
-      WALMetaEntry& entry = logging.reserveWALMetaEntry();
-      entry.type = WALEntry::TYPE::TX_COMMIT;
-      // TODO: commit_ts in log
-      logging.submitWALMetaEntry();
-      if (FLAGS_wal_variant == 2) {
-        logging.wt_to_lw.optimistic_latch.notify_all();
+      if (activeTX().isDurable()) {
+        WALMetaEntry& entry = logging.reserveWALMetaEntry();
+        entry.type = WALEntry::TYPE::TX_COMMIT;
+        // TODO: commit_ts in log
+        logging.submitWALMetaEntry();
+        if (FLAGS_wal_variant == 2) {
+          logging.wt_to_lw.optimistic_latch.notify_all();
+        }
       }
       // -------------------------------------------------------------------------------------
       active_tx.stats.precommit = std::chrono::high_resolution_clock::now();
-      std::unique_lock<std::mutex> g(logging.precommitted_queue_mutex);
-      if (logging.remote_flush_dependency) {  // RFA
-        logging.precommitted_queue.push_back(active_tx);
+      if (activeTX().waitsForGroupCommit()) {
+        const Logging::PrecommittedTX precommitted_tx = {.start_ts = active_tx.startTS(),
+                                                         .commit_ts = active_tx.commitTS(),
+                                                         .max_observed_gsn = active_tx.max_observed_gsn,
+                                                         .start = active_tx.stats.start,
+                                                         .precommit = active_tx.stats.precommit};
+        if (logging.remote_flush_dependency) {  // RFA
+          logging.precommitted_queue.push(precommitted_tx);
+        } else {
+          CRCounters::myCounters().rfa_committed_tx++;
+          logging.precommitted_queue_rfa.push(precommitted_tx);
+        }
+        // -------------------------------------------------------------------------------------
+        if (active_tx.durability == TX_DURABILITY::SYNC && activeTX().hasWrote()) {
+          // The single group committer snapshots every published WAL at the start of a round, so the second round that completes
+          // after our precommit flushed our WAL and everything we depend on, even while RFA signaling lags behind idle workers
+          const u64 hardened_after_round = global.gct_rounds.load() + 2;
+          // Spin briefly, then block until the group committer signals us or completes a round (wakeUpSyncCommit).
+          // The wake-up counter is read before the condition, so a wake-up in between is not lost
+          constexpr u64 spins_before_blocking = 64;
+          logging.sync_commit_ts.store(active_tx.commitTS());
+          for (u64 spin_i = 0;; spin_i++) {
+            const u64 wakeups = logging.sync_wakeups.load();
+            if (logging.signaled_commit_ts.load() >= active_tx.commitTS() ||
+                (FLAGS_wal_variant == 0 && global.gct_rounds.load() >= hardened_after_round)) {
+              break;
+            }
+            // Remote flush dependencies of other waiting workers may need our GSN to move forward, the sync point moves once per round
+            const LID sync_point = global.sync_to_this_gsn.load();
+            if (sync_point > logging.getCurrentGSN()) {
+              logging.setCurrentGSN(sync_point);
+              logging.publishMaxGSNOffset();
+            }
+            if (spin_i < spins_before_blocking) {
+              std::this_thread::yield();
+            } else {
+              logging.sync_wakeups.wait(wakeups);
+            }
+          }
+          logging.sync_commit_ts.store(0, std::memory_order_release);
+          CRCounters::myCounters().sync_committed_tx++;
+        }
       } else {
-        CRCounters::myCounters().rfa_committed_tx++;
-        logging.precommitted_queue_rfa.push_back(active_tx);
+        CRCounters::myCounters().async_committed_tx++;
       }
     }
     // Only committing snapshot/ changing between SI and lower modes
@@ -178,6 +235,7 @@ void Worker::abortTX()
    ensure(FLAGS_wal);
    ensure(!active_tx.wal_larger_than_buffer);
    ensure(active_tx.state == Transaction::STATE::STARTED);
+   ensure(active_tx.current_tx_mode != TX_MODE::DETERMINISTIC);  // Batch updates of chained tuples have no undo
    const u64 tx_id = active_tx.startTS();
    std::vector<const WALEntry*> entries;
    logging.iterateOverCurrentTXEntries([&](const WALEntry& entry) {
@@ -185,16 +243,24 @@ void Worker::abortTX()
          entries.push_back(&entry);
       }
    });
+   // NON_DURABLE: the entries are in the undo buffer instead, moved out because undoing may append to it
+   const std::vector<u8> undo_buffer = std::move(logging.undo_buffer);
+   logging.undo_buffer.clear();
+   for (u64 offset = 0; offset < undo_buffer.size(); offset += reinterpret_cast<const WALEntry*>(undo_buffer.data() + offset)->size) {
+      entries.push_back(reinterpret_cast<const WALEntry*>(undo_buffer.data() + offset));
+   }
    std::for_each(entries.rbegin(), entries.rend(), [&](const WALEntry* entry) {
       const auto& dt_entry = *reinterpret_cast<const WALDTEntry*>(entry);
-      leanstore::storage::DTRegistry::global_dt_registry.undo(dt_entry.dt_id, dt_entry.payload, tx_id);
+      leanstore::storage::BMC::global_bf->getDTRegistry().undo(dt_entry.dt_id, dt_entry.payload, tx_id);
    });
    // -------------------------------------------------------------------------------------
    cc.history_tree.purgeVersions(worker_id, active_tx.startTS(), active_tx.startTS(), [&](const TXID, const DTID, const u8*, u64, const bool) {});
    // -------------------------------------------------------------------------------------
-   WALMetaEntry& entry = logging.reserveWALMetaEntry();
-   entry.type = WALEntry::TYPE::TX_ABORT;
-   logging.submitWALMetaEntry();
+   if (active_tx.isDurable()) {
+      WALMetaEntry& entry = logging.reserveWALMetaEntry();
+      entry.type = WALEntry::TYPE::TX_ABORT;
+      logging.submitWALMetaEntry();
+   }
    active_tx.state = Transaction::STATE::ABORTED;
    jumpmu::jump();
 }
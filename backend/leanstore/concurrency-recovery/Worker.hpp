@@ -3,11 +3,14 @@
 #include "Transaction.hpp"
 #include "WALEntry.hpp"
 #include "leanstore/profiling/counters/CRCounters.hpp"
+#include "leanstore/profiling/counters/RegionCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
 // -------------------------------------------------------------------------------------
 #include "leanstore/utils/OptimisticSpinStruct.hpp"
+#include "leanstore/utils/RingBufferSPSC.hpp"
 // -------------------------------------------------------------------------------------
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <list>
 #include <map>
@@ -32,13 +35,6 @@ struct Worker {
    // Static members
    static thread_local Worker* tls_ptr;
    // -------------------------------------------------------------------------------------
-   // Concurrency Control
-   static unique_ptr<atomic<u64>[]> global_workers_current_snapshot;
-   static atomic<TXID> global_oldest_oltp_start_ts, global_oltp_lwm;
-   static atomic<TXID> global_oldest_all_start_ts, global_all_lwm;
-   static atomic<TXID> global_newest_olap_start_ts;
-   static std::shared_mutex global_mutex;
-   // -------------------------------------------------------------------------------------
    static constexpr u64 WORKERS_BITS = 8;
    static constexpr u64 WORKERS_INCREMENT = 1ull << WORKERS_BITS;
    static constexpr u64 WORKERS_MASK = (1ull << WORKERS_BITS) - 1;
@@ -51,22 +47,48 @@ struct Worker {
    // LWM : [LATCH_BIT | RC_BIT | OLTP_OLAP_SAME_BIT | id];
    static constexpr s64 CR_ENTRY_SIZE = sizeof(WALMetaEntry);
    // -------------------------------------------------------------------------------------
+   // Shared by the workers of one LeanStore instance, owned by its CRManager
+   struct Global {
+      // Concurrency Control
+      unique_ptr<atomic<u64>[]> workers_current_snapshot;  // All transactions < are committed
+      atomic<TXID> oldest_oltp_start_ts = 0, oltp_lwm = 0;
+      atomic<TXID> oldest_all_start_ts = 0, all_lwm = 0;
+      atomic<TXID> newest_olap_start_ts = 0;
+      std::shared_mutex mutex;
+      atomic<u64> clock = WORKERS_INCREMENT;
+      // -------------------------------------------------------------------------------------
+      // Logging
+      atomic<u64> min_gsn_flushed = 0;   // The minimum of all workers maximum flushed GSN
+      atomic<u64> sync_to_this_gsn = 0;  // Artifically increment the workers GSN to this point at the next round to prevent GSN from
+                                         // skewing and undermining RFA
+      atomic<u64> min_commit_ts_flushed = 0;
+      atomic<u64> gct_rounds = 0;  // Completed rounds of the single group committer (wal_variant 0)
+   };
+   Global& global;
+   // -------------------------------------------------------------------------------------
    // Worker Local
    struct Logging {
-      static atomic<u64> global_min_gsn_flushed;   // The minimum of all workers maximum flushed GSN
-      static atomic<u64> global_sync_to_this_gsn;  // Artifically increment the workers GSN to this point at the next round to prevent GSN from
-                                                   // skewing and undermining RFA
-      static atomic<u64> global_min_commit_ts_flushed;
-      // -------------------------------------------------------------------------------------
       s64 WORKER_WAL_SIZE = 0;
       WALMetaEntry* active_mt_entry;
       WALDTEntry* active_dt_entry;
-      // Shared between Group Committer and Worker
-      std::mutex precommitted_queue_mutex;
-      std::vector<Transaction> precommitted_queue;
-      std::vector<Transaction> precommitted_queue_rfa;
+      WALBatchInputEntry* active_bi_entry;
+      // Compact descriptor of a pre-committed transaction, everything the group committer needs to signal it
+      struct PrecommittedTX {
+         TXID start_ts;
+         TXID commit_ts;
+         LID max_observed_gsn;
+         std::chrono::high_resolution_clock::time_point start, precommit;
+         u64 flushes_counter = 0;  // W: GCT
+      };
+      // Shared between Group Committer and Worker (single producer: WT, single consumer: GCT)
+      utils::RingBufferSPSC<PrecommittedTX> precommitted_queue{FLAGS_wal_precommitted_queue_size};
+      utils::RingBufferSPSC<PrecommittedTX> precommitted_queue_rfa{FLAGS_wal_precommitted_queue_size};
       // -------------------------------------------------------------------------------------
       std::atomic<TXID> hardened_commit_ts = 0, signaled_commit_ts = 0;  // W: LW, R: WT
+      std::atomic<TXID> sync_commit_ts = 0;                              // W: WT, R: GCT, != 0 while a SYNC commit waits
+      std::atomic<u64> sync_wakeups = 0;                                 // W: GCT, R: WT, the SYNC commit blocks on it
+      void signalCommitted(TXID commit_ts);
+      void wakeUpSyncCommit();
       std::atomic<TXID> hardened_gsn = 0;                                // W: LW, R: LC
       // -------------------------------------------------------------------------------------
       // Protect W+GCT shared data (worker <-> group commit thread)
@@ -123,8 +145,18 @@ struct Worker {
       template <typename T>
       WALEntryHandler<T> reserveDTEntry(u64 requested_size, PID pid, LID gsn, DTID dt_id)
       {
-         const auto lsn = wal_lsn_counter++;
          const u64 total_size = sizeof(WALDTEntry) + requested_size;
+         if (!my().active_tx.isDurable()) {
+            undo_buffer.resize(undo_buffer.size() + total_size);
+            active_dt_entry = new (undo_buffer.data() + undo_buffer.size() - total_size) WALDTEntry();
+            active_dt_entry->type = WALEntry::TYPE::DT_SPECIFIC;
+            active_dt_entry->size = total_size;
+            active_dt_entry->pid = pid;
+            active_dt_entry->gsn = gsn;
+            active_dt_entry->dt_id = dt_id;
+            return {active_dt_entry->payload, total_size, 0, 0};
+         }
+         const auto lsn = wal_lsn_counter++;
          ensure(walContiguousFreeSpace() >= total_size);
          active_dt_entry = new (wal_buffer + wal_wt_cursor) WALDTEntry();
          active_dt_entry->lsn.store(lsn, std::memory_order_release);
@@ -161,10 +193,17 @@ struct Worker {
       // Iterate over current TX entries
       u64 current_tx_wal_start;
       void iterateOverCurrentTXEntries(std::function<void(const WALEntry& entry)> callback);
+      // The DT entries of a NON_DURABLE transaction never reach the WAL, they are kept here for abortTX only
+      std::vector<u8> undo_buffer;
+      // Called when a NON_DURABLE transaction commits durably after all, before its commit record
+      void moveUndoBufferToWAL();
       // -------------------------------------------------------------------------------------
       // Without Payload, by submit no need to update clock (gsn)
       WALMetaEntry& reserveWALMetaEntry();
       void submitWALMetaEntry();
+      // Deterministic batches log the input of their transactions instead of the changes
+      WALBatchInputEntry& reserveWALBatchInputEntry(u16 input_length);
+      void submitWALBatchInputEntry();
       inline LID getCurrentGSN() { return wt_gsn_clock; }
       inline void setCurrentGSN(LID gsn) { wt_gsn_clock = gsn; }
       // -------------------------------------------------------------------------------------
@@ -174,8 +213,6 @@ struct Worker {
    // Concurrency Control
    // LWM: start timestamp of the transaction that has its effect visible by all in its class
    struct ConcurrencyControl {
-      static atomic<u64> global_clock;
-      // -------------------------------------------------------------------------------------
       atomic<TXID> local_lwm_latch = 0;
       atomic<TXID> oltp_lwm_receiver;
       atomic<TXID> all_lwm_receiver;
@@ -258,10 +295,14 @@ struct Worker {
    const u64 worker_id;
    Worker** all_workers;
    const u64 workers_count;
-   const s32 ssd_fd;
    const bool is_page_provider = false;
    // -------------------------------------------------------------------------------------
-   Worker(u64 worker_id, Worker** all_workers, u64 workers_count, HistoryTreeInterface& versions_space, s32 fd, const bool is_page_provider = false);
+   Worker(u64 worker_id,
+          Worker** all_workers,
+          u64 workers_count,
+          Global& global,
+          HistoryTreeInterface& versions_space,
+          const bool is_page_provider = false);
    static inline Worker& my() { return *Worker::tls_ptr; }
    ~Worker();
    // -------------------------------------------------------------------------------------
@@ -272,8 +313,11 @@ struct Worker {
    // TX Control
    void startTX(TX_MODE next_tx_type = TX_MODE::OLTP,
                 TX_ISOLATION_LEVEL next_tx_isolation_level = TX_ISOLATION_LEVEL::SNAPSHOT_ISOLATION,
-                bool read_only = false);
+                bool read_only = false,
+                TX_DURABILITY durability = TX_DURABILITY::GROUP);
    void commitTX();
+   // Overrides the durability chosen at startTX, e.g., once the transaction knows what it wrote
+   void commitTX(TX_DURABILITY durability);
    void abortTX();
    void shutdown();
    inline WORKERID workerID() { return worker_id; }
@@ -19,10 +19,14 @@ struct CRCounters {
    atomic<u64> gct_phase_2_ms = 0;
    atomic<u64> gct_write_ms = 0;
    atomic<u64> gct_write_bytes = 0;
+   atomic<u64> gct_parked_ms = 0;  // Idle back-off
+   atomic<u64> gct_gather_ms = 0;  // Rounds held back to batch flushes
    // -------------------------------------------------------------------------------------
    atomic<u64> gct_rounds = 0;
    atomic<u64> gct_committed_tx = 0;
    atomic<u64> rfa_committed_tx = 0;
+   atomic<u64> async_committed_tx = 0;  // ASYNC and NON_DURABLE, not tracked by the group committer
+   atomic<u64> sync_committed_tx = 0;
    // -------------------------------------------------------------------------------------
    atomic<u64> cc_prepare_igc = 0;
    atomic<u64> cc_cross_workers_visibility_check = 0;
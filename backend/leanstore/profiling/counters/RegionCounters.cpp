@@ -0,0 +1,125 @@
+#include "RegionCounters.hpp"
+
+#include "Exceptions.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <asm/unistd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+std::mutex RegionCounters::mutex;
+std::vector<string> RegionCounters::regions_names = {"descent", "version_reconstruction", "wal_append", "commit"};
+tbb::enumerable_thread_specific<RegionCounters> RegionCounters::region_counters;
+const char* RegionCounters::events_names[events_count] = {"cycle", "instr", "L1-miss", "LLC-miss", "dTLB-miss"};
+// -------------------------------------------------------------------------------------
+namespace
+{
+#ifdef __x86_64__
+// Self-monitoring as described in linux/perf_event.h, false when the event has to be read with read()
+bool readUserSpace(volatile perf_event_mmap_page* page, u64& value)
+{
+   u32 seq;
+   do {
+      seq = page->lock;
+      asm volatile("" ::: "memory");
+      const u32 index = page->index;
+      if (!page->cap_user_rdpmc || index == 0) {
+         return false;
+      }
+      const u16 width = page->pmc_width;
+      s64 pmc = __builtin_ia32_rdpmc(index - 1);
+      pmc <<= 64 - width;
+      pmc >>= 64 - width;
+      value = page->offset + pmc;
+      asm volatile("" ::: "memory");
+   } while (page->lock != seq);
+   return true;
+}
+#endif
+}  // namespace
+// -------------------------------------------------------------------------------------
+RegionCounters::RegionCounters()
+{
+   for (u64 e_i = 0; e_i < events_count; e_i++) {
+      fds[e_i] = -1;
+      pages[e_i] = nullptr;
+   }
+   if (!FLAGS_profile_regions) {
+      return;
+   }
+   const std::pair<u32, u64> configs[events_count] = {
+       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+       {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+       {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}};
+   // One group led by the cycles, so that the events of a region are counted over the same time
+   for (u64 e_i = 0; e_i < events_count; e_i++) {
+      perf_event_attr pe;
+      memset(&pe, 0, sizeof(perf_event_attr));
+      pe.type = configs[e_i].first;
+      pe.size = sizeof(perf_event_attr);
+      pe.config = configs[e_i].second;
+      pe.exclude_hv = true;
+      fds[e_i] = syscall(__NR_perf_event_open, &pe, 0, -1, (e_i == 0) ? -1 : fds[0], 0);
+      if (fds[e_i] < 0) {
+         std::cerr << "Error opening counter " << events_names[e_i] << std::endl;
+         fds[e_i] = -1;
+         if (e_i == 0) {
+            return;
+         }
+         continue;
+      }
+      void* page = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, fds[e_i], 0);
+      pages[e_i] = (page == MAP_FAILED) ? nullptr : reinterpret_cast<perf_event_mmap_page*>(page);
+   }
+}
+RegionCounters::~RegionCounters()
+{
+   for (u64 e_i = 0; e_i < events_count; e_i++) {
+      if (pages[e_i]) {
+         munmap(pages[e_i], sysconf(_SC_PAGESIZE));
+      }
+      if (fds[e_i] != -1) {
+         close(fds[e_i]);
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+void RegionCounters::read(u64* values)
+{
+   for (u64 e_i = 0; e_i < events_count; e_i++) {
+      values[e_i] = 0;
+      if (fds[e_i] == -1) {
+         continue;
+      }
+#ifdef __x86_64__
+      if (pages[e_i] && readUserSpace(pages[e_i], values[e_i])) {
+         continue;
+      }
+#endif
+      u64 value;
+      if (::read(fds[e_i], &value, sizeof(value)) == sizeof(value)) {
+         values[e_i] = value;
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+u64 RegionCounters::registerRegion(const string& name)
+{
+   std::unique_lock guard(mutex);
+   for (u64 r_i = 0; r_i < regions_names.size(); r_i++) {
+      if (regions_names[r_i] == name) {
+         return r_i;
+      }
+   }
+   ensure(regions_names.size() < max_regions);
+   regions_names.push_back(name);
+   return regions_names.size() - 1;
+}
+}  // namespace leanstore
@@ -0,0 +1,81 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/utils/JumpMU.hpp"
+// -------------------------------------------------------------------------------------
+#include <linux/perf_event.h>
+#include <tbb/enumerable_thread_specific.h>
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+// Hardware events per region: the engine phases below and the transaction types the frontends register.
+// Each thread opens one perf event group on first use and reads it from user space with rdpmc, read() is the fallback when the
+// kernel does not allow rdpmc or the group is not on the PMU. Regions are inclusive, a descent during new_order counts for both.
+// Keep cpu_counters off, otherwise the events are multiplexed with the ones of CPUCounters and the regions miss some of them
+struct RegionCounters {
+   static constexpr u64 max_regions = 32;
+   static constexpr u64 events_count = 5;
+   enum ENGINE_REGION : u64 { DESCENT = 0, VERSION_RECONSTRUCTION = 1, WAL_APPEND = 2, COMMIT = 3 };
+   static const char* events_names[events_count];
+   // -------------------------------------------------------------------------------------
+   atomic<u64> calls[max_regions] = {0};
+   atomic<u64> events[max_regions][events_count] = {};
+   // -------------------------------------------------------------------------------------
+   // Only touched by the owning thread
+   s32 fds[events_count];
+   perf_event_mmap_page* pages[events_count];
+   // -------------------------------------------------------------------------------------
+   RegionCounters();
+   ~RegionCounters();
+   // Current values of the events of this thread, 0 for the ones that could not be opened
+   void read(u64* values);
+   // -------------------------------------------------------------------------------------
+   static std::mutex mutex;
+   static std::vector<string> regions_names;
+   // Returns the id of the region, registers it on first use
+   static u64 registerRegion(const string& name);
+   static tbb::enumerable_thread_specific<RegionCounters> region_counters;
+   static RegionCounters& myCounters() { return region_counters.local(); }
+};
+// -------------------------------------------------------------------------------------
+// Attributes the events from construction to destruction to the region. count_call = false adds them to the current call,
+// for the parts of a region that are spread over several functions
+struct RegionScope {
+   RegionCounters* counters = nullptr;
+   const u64 region;
+   const bool count_call;
+   u64 begin[RegionCounters::events_count];
+   RegionScope(u64 region, bool count_call = true) : region(region), count_call(count_call)
+   {
+      if (FLAGS_profile_regions) {
+         counters = &RegionCounters::myCounters();
+         counters->read(begin);
+      }
+   }
+   ~RegionScope()
+   {
+      if (counters) {
+         u64 end[RegionCounters::events_count];
+         counters->read(end);
+         for (u64 e_i = 0; e_i < RegionCounters::events_count; e_i++) {
+            counters->events[region][e_i] += end[e_i] - begin[e_i];
+         }
+         if (count_call) {
+            counters->calls[region]++;
+         }
+      }
+   }
+};
+}  // namespace leanstore
+// -------------------------------------------------------------------------------------
+// Wrapped in JMUW, the scope may be left by a jump
+#ifdef MACRO_COUNTERS_ALL
+#define PROFILE_REGION(...) JMUW<leanstore::RegionScope> profile_region(__VA_ARGS__)
+#else
+#define PROFILE_REGION(...)
+#endif
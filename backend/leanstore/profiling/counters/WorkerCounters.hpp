@@ -13,6 +13,7 @@ namespace leanstore
 struct WorkerCounters {
    static constexpr u64 max_researchy_counter = 10;
    static constexpr u64 max_dt_id = 1000;  // ATTENTION: buffer overflow if more than max_dt_id in system are registered
+   static constexpr u64 max_ssds = 64;
    // -------------------------------------------------------------------------------------
    atomic<u64> t_id = 9999;                // used by tpcc
    atomic<u64> variable_for_workload = 0;  // Used by tpcc
@@ -22,7 +23,10 @@ struct WorkerCounters {
    atomic<u64> hot_hit_counter = 0;  // TODO: give it a try ?
    atomic<u64> cold_hit_counter = 0;
    atomic<u64> read_operations_counter = 0;
+   atomic<u64> ssd_reads[max_ssds] = {0};   // per data device
+   atomic<u64> ssd_writes[max_ssds] = {0};  // by the page providers
    atomic<u64> allocate_operations_counter = 0;
+   atomic<u64> backpressure_us = 0;
    atomic<u64> restarts_counter = 0;
    atomic<u64> tx = 0;
    atomic<u64> olap_tx = 0;
@@ -43,6 +47,9 @@ struct WorkerCounters {
    atomic<u64> xmerge_full_counter[max_dt_id] = {0};
    // -------------------------------------------------------------------------------------
    atomic<u64> dt_page_reads[max_dt_id] = {0};
+   atomic<u64> dt_prefetch_requests[max_dt_id] = {0};
+   atomic<u64> dt_page_prefetches[max_dt_id] = {0};
+   atomic<u64> dt_released_pages[max_dt_id] = {0};  // scan-only pages evicted/cooled by the worker that left them
    atomic<u64> dt_page_writes[max_dt_id] = {0};
    atomic<u64> dt_restarts_update_same_size[max_dt_id] = {0};   // without structural change
    atomic<u64> dt_restarts_structural_change[max_dt_id] = {0};  // includes insert, remove, update with different size
@@ -53,6 +60,8 @@ struct WorkerCounters {
    atomic<u64> dt_find_parent_root[max_dt_id] = {0};
    atomic<u64> dt_find_parent_fast[max_dt_id] = {0};
    atomic<u64> dt_find_parent_slow[max_dt_id] = {0};
+   atomic<u64> dt_find_parent_path_hint[max_dt_id] = {0};
+   atomic<u64> dt_cursor_resume_hint[max_dt_id] = {0};  // resume() found the leaf unchanged
    // -------------------------------------------------------------------------------------
    atomic<u64> dt_empty_leaf[max_dt_id] = {0};
    atomic<u64> dt_goto_page_exec[max_dt_id] = {0};
@@ -65,6 +74,7 @@ struct WorkerCounters {
    atomic<u64> dt_scan_asc[max_dt_id] = {0};
    atomic<u64> dt_scan_desc[max_dt_id] = {0};
    atomic<u64> dt_scan_callback[max_dt_id] = {0};
+   atomic<u64> dt_cold_replica_rows[max_dt_id] = {0};  // Rows scanOLAP took from the columnar replica
    // -------------------------------------------------------------------------------------
    atomic<u64> dt_range_removed[max_dt_id] = {0};
    atomic<u64> dt_append[max_dt_id] = {0};
@@ -72,8 +82,10 @@ struct WorkerCounters {
    // -------------------------------------------------------------------------------------
    atomic<u64> cc_read_versions_visited[max_dt_id] = {0};
    atomic<u64> cc_read_versions_visited_not_found[max_dt_id] = {0};
+   atomic<u64> cc_read_versions_inline[max_dt_id] = {0};
    atomic<u64> cc_read_chains_not_found[max_dt_id] = {0};
    atomic<u64> cc_read_chains[max_dt_id] = {0};
+   atomic<u64> cc_read_chains_elided[max_dt_id] = {0};  // Aborted on an elided before-image
    // -------------------------------------------------------------------------------------
    atomic<u64> cc_update_versions_visited[max_dt_id] = {0};
    atomic<u64> cc_update_versions_removed[max_dt_id] = {0};
@@ -82,6 +94,7 @@ struct WorkerCounters {
    atomic<u64> cc_update_versions_skipped[max_dt_id] = {0};
    atomic<u64> cc_update_versions_recycled[max_dt_id] = {0};
    atomic<u64> cc_update_versions_created[max_dt_id] = {0};
+   atomic<u64> cc_update_versions_elided[max_dt_id] = {0};
    atomic<u64> cc_update_chains[max_dt_id] = {0};
    atomic<u64> cc_update_chains_hwm[max_dt_id] = {0};
    atomic<u64> cc_update_chains_pgc[max_dt_id] = {0};
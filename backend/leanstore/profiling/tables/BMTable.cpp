@@ -48,6 +48,8 @@ void BMTable::open()
    columns.emplace("rounds", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::pp_thread_rounds)); });
    columns.emplace("touches", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::touched_bfs_counter)); });
    columns.emplace("unswizzled", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::unswizzled_pages_counter)); });
+   columns.emplace("trimmed", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::trimmed_pages_counter)); });
+   columns.emplace("cleaned", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::cleaned_pages_counter)); });
    columns.emplace("submit_ms", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::submit_ms) * 100.0 / total); });
    columns.emplace("async_mb_ws", [&](Column& col) { col << (sum(PPCounters::pp_counters, &PPCounters::async_wb_ms)); });
    columns.emplace("w_mib", [&](Column& col) {
@@ -55,9 +57,23 @@ void BMTable::open()
    });
    // -------------------------------------------------------------------------------------
    columns.emplace("allocate_ops", [&](Column& col) { col << (sum(WorkerCounters::worker_counters, &WorkerCounters::allocate_operations_counter)); });
+   columns.emplace("backpressure_ms", [&](Column& col) { col << (sum(WorkerCounters::worker_counters, &WorkerCounters::backpressure_us) / 1000.0); });
    columns.emplace("r_mib", [&](Column& col) {
       col << (sum(WorkerCounters::worker_counters, &WorkerCounters::read_operations_counter) * EFFECTIVE_PAGE_SIZE / 1024.0 / 1024.0);
    });
+   // -------------------------------------------------------------------------------------
+   // Per data device when striping
+   if (bm.getSSDsCount() > 1) {
+      for (u64 ssd_i = 0; ssd_i < bm.getSSDsCount(); ssd_i++) {
+         const std::string prefix = "ssd_" + std::to_string(ssd_i);
+         columns.emplace(prefix + "_r_mib", [&, ssd_i](Column& col) {
+            col << (sum(WorkerCounters::worker_counters, &WorkerCounters::ssd_reads, ssd_i) * EFFECTIVE_PAGE_SIZE / 1024.0 / 1024.0);
+         });
+         columns.emplace(prefix + "_w_mib", [&, ssd_i](Column& col) {
+            col << (sum(WorkerCounters::worker_counters, &WorkerCounters::ssd_writes, ssd_i) * EFFECTIVE_PAGE_SIZE / 1024.0 / 1024.0);
+         });
+      }
+   }
 }
 // -------------------------------------------------------------------------------------
 void BMTable::next()
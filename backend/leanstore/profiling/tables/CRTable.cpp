@@ -28,12 +28,16 @@ void CRTable::open()
    columns.emplace("gct_write_pct", [&](Column& col) { col << 100.0 * write / total; });
    columns.emplace("gct_committed_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::gct_committed_tx); });
    columns.emplace("gct_rounds", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::gct_rounds); });
+   columns.emplace("gct_parked_ms", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::gct_parked_ms); });
+   columns.emplace("gct_gather_ms", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::gct_gather_ms); });
    columns.emplace("tx", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::tx); });
    columns.emplace("tx_abort", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::tx_abort); });
    columns.emplace("olap_tx", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::olap_tx); });
    columns.emplace("olap_scanned_tuples", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::olap_scanned_tuples); });
    columns.emplace("olap_tx_abort", [](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::olap_tx_abort); });
    columns.emplace("rfa_committed_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::rfa_committed_tx); });
+   columns.emplace("async_committed_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::async_committed_tx); });
+   columns.emplace("sync_committed_tx", [&](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::sync_committed_tx); });
    // -------------------------------------------------------------------------------------
    columns.emplace("cc_snapshot_restart", [](Column& col) { col << sum(CRCounters::cr_counters, &CRCounters::cc_snapshot_restart); });
    // -------------------------------------------------------------------------------------
@@ -31,6 +31,12 @@ void ConfigsTable::open()
    columns.emplace("c_partition_bits", [&](Column& col) { col << FLAGS_partition_bits; });
    columns.emplace("c_dram_gib", [&](Column& col) { col << FLAGS_dram_gib; });
    columns.emplace("c_ssd_gib", [&](Column& col) { col << FLAGS_ssd_gib; });
+   columns.emplace("c_ssd_emulated", [&](Column& col) { col << FLAGS_ssd_emulated; });
+   columns.emplace("c_ssd_emu_read_us", [&](Column& col) { col << FLAGS_ssd_emu_read_us; });
+   columns.emplace("c_ssd_emu_write_us", [&](Column& col) { col << FLAGS_ssd_emu_write_us; });
+   columns.emplace("c_ssd_emu_fsync_us", [&](Column& col) { col << FLAGS_ssd_emu_fsync_us; });
+   columns.emplace("c_ssd_emu_mib_s", [&](Column& col) { col << FLAGS_ssd_emu_mib_s; });
+   columns.emplace("c_ssd_emu_queue_depth", [&](Column& col) { col << FLAGS_ssd_emu_queue_depth; });
    columns.emplace("c_target_gib", [&](Column& col) { col << FLAGS_target_gib; });
    columns.emplace("c_run_for_seconds", [&](Column& col) { col << FLAGS_run_for_seconds; });
    columns.emplace("c_bulk_insert", [&](Column& col) { col << FLAGS_bulk_insert; });
@@ -24,7 +24,14 @@ void DTTable::open()
    columns.emplace("key", [&](Column& col) { col << dt_id; });
    columns.emplace("dt_name", [&](Column& col) { col << dt_name; });
    columns.emplace("dt_page_reads", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_page_reads, dt_id); });
+   columns.emplace("dt_prefetch_requests", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_prefetch_requests, dt_id); });
+   columns.emplace("dt_page_prefetches", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_page_prefetches, dt_id); });
+   columns.emplace("dt_released_pages", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_released_pages, dt_id); });
    columns.emplace("dt_page_writes", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_page_writes, dt_id); });
+   columns.emplace("dt_resident_pages", [&](Column& col) { col << bm.getDTRegistry().dt_resident_pages[dt_id].load(); });
+   columns.emplace("quota_group", [&](Column& col) { col << bm.getDTRegistry().dt_quota_group[dt_id].load(); });
+   columns.emplace("group_resident_pages",
+                   [&](Column& col) { col << bm.getDTRegistry().quota_groups[bm.getDTRegistry().dt_quota_group[dt_id]].resident_pages.load(); });
    columns.emplace("dt_restarts_update_same_size",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_restarts_update_same_size, dt_id); });
    columns.emplace("dt_restarts_structural_change",
@@ -43,6 +50,8 @@ void DTTable::open()
    columns.emplace("dt_scan_asc", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_scan_asc, dt_id); });
    columns.emplace("dt_scan_desc", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_scan_desc, dt_id); });
    columns.emplace("dt_scan_callback", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_scan_callback, dt_id); });
+   columns.emplace("dt_cold_replica_rows",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_cold_replica_rows, dt_id); });
    // -------------------------------------------------------------------------------------
    columns.emplace("dt_append", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_append, dt_id); });
    columns.emplace("dt_append_opt", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_append_opt, dt_id); });
@@ -77,14 +86,22 @@ void DTTable::open()
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_find_parent_fast, dt_id); });
    columns.emplace("dt_find_parent_slow",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_find_parent_slow, dt_id); });
+   columns.emplace("dt_find_parent_path_hint",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_find_parent_path_hint, dt_id); });
+   columns.emplace("dt_cursor_resume_hint",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::dt_cursor_resume_hint, dt_id); });
    // -------------------------------------------------------------------------------------
    columns.emplace("cc_read_versions_visited",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_versions_visited, dt_id); });
    columns.emplace("cc_read_versions_visited_not_found",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_versions_visited_not_found, dt_id); });
+   columns.emplace("cc_read_versions_inline",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_versions_inline, dt_id); });
    columns.emplace("cc_read_chains", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_chains, dt_id); });
    columns.emplace("cc_read_chains_not_found",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_chains_not_found, dt_id); });
+   columns.emplace("cc_read_chains_elided",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_read_chains_elided, dt_id); });
    // -------------------------------------------------------------------------------------
    columns.emplace("cc_update_versions_visited",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_update_versions_visited, dt_id); });
@@ -101,6 +118,8 @@ void DTTable::open()
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_update_versions_recycled, dt_id); });
    columns.emplace("cc_update_versions_created",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_update_versions_created, dt_id); });
+   columns.emplace("cc_update_versions_elided",
+                   [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_update_versions_elided, dt_id); });
    columns.emplace("cc_update_chains", [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_update_chains, dt_id); });
    columns.emplace("cc_update_chains_hwm",
                    [&](Column& col) { col << sum(WorkerCounters::worker_counters, &WorkerCounters::cc_update_chains_hwm, dt_id); });
@@ -0,0 +1,50 @@
+#include "RegionTable.hpp"
+
+#include "leanstore/Config.hpp"
+#include "leanstore/profiling/counters/RegionCounters.hpp"
+#include "leanstore/utils/ThreadLocalAggregator.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+using leanstore::utils::threadlocal::sum;
+namespace leanstore
+{
+namespace profiling
+{
+// -------------------------------------------------------------------------------------
+std::string RegionTable::getName()
+{
+   return "regions";
+}
+// -------------------------------------------------------------------------------------
+void RegionTable::open()
+{
+   columns.emplace("key", [](Column&) {});
+   columns.emplace("calls", [](Column&) {});
+   for (u64 e_i = 0; e_i < RegionCounters::events_count; e_i++) {
+      columns.emplace(RegionCounters::events_names[e_i], [](Column&) {});
+   }
+}
+// -------------------------------------------------------------------------------------
+void RegionTable::next()
+{
+   clear();
+   // -------------------------------------------------------------------------------------
+   std::vector<string> regions_names;
+   {
+      std::unique_lock guard(RegionCounters::mutex);
+      regions_names = RegionCounters::regions_names;
+   }
+   for (u64 r_i = 0; r_i < regions_names.size(); r_i++) {
+      const u64 calls = sum(RegionCounters::region_counters, &RegionCounters::calls, r_i);
+      columns.at("key") << regions_names[r_i];
+      columns.at("calls") << calls;
+      for (u64 e_i = 0; e_i < RegionCounters::events_count; e_i++) {
+         const double events = sum(RegionCounters::region_counters, &RegionCounters::events, r_i, e_i);
+         columns.at(RegionCounters::events_names[e_i]) << ((calls) ? events / calls : 0.0);
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+}  // namespace profiling
+}  // namespace leanstore
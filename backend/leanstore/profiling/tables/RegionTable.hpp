@@ -0,0 +1,19 @@
+#pragma once
+#include "ProfilingTable.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace profiling
+{
+// One row per region with its calls and the events per call, see RegionCounters
+class RegionTable : public ProfilingTable
+{
+  public:
+   virtual std::string getName();
+   virtual void open();
+   virtual void next();
+};
+}  // namespace profiling
+}  // namespace leanstore
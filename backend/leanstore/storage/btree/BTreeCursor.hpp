@@ -0,0 +1,173 @@
+#pragma once
+#include "BTreeLL.hpp"
+#include "core/BTreeGenericIterator.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+// Ordered access to a BTreeLL without callbacks, e.g., for merge joins over several trees.
+// While positioned, the cursor holds the leaf latched in shared mode: key() and value() point into the page.
+// pause() drops the latches and remembers the current key together with the leaf version,
+// resume() relatches the same leaf if its version did not change, otherwise it seeks the remembered key again.
+// ATTENTION: the underlying page guards live on the jumpmu destructor stack of the worker thread,
+// hence cursors must be destroyed in reverse order of construction (i.e., keep them on the stack)
+// and have to be paused before the same thread modifies the tree
+class BTreeCursor
+{
+  private:
+   BTreeSharedIterator iterator;
+   bool is_valid = false;
+   bool is_paused = false;
+   // After a resume whose key was removed meanwhile, we stand on its successor (resp. predecessor) already
+   bool next_is_current = false;
+   bool prev_is_current = false;
+   StringU paused_key;
+   // -------------------------------------------------------------------------------------
+   OP_RESULT position(OP_RESULT ret)
+   {
+      is_valid = (ret == OP_RESULT::OK);
+      next_is_current = prev_is_current = false;
+      if (is_valid) {
+         iterator.assembleKey();
+      }
+      return ret;
+   }
+   void resumeIfPaused()
+   {
+      if (is_paused) {
+         resume();
+      }
+   }
+   // A paused iterator must not look at its leaf before seeking again
+   void forgetPaused()
+   {
+      if (is_paused) {
+         iterator.reset();
+         is_paused = false;
+      }
+   }
+
+  public:
+   BTreeCursor(BTreeLL& btree) : iterator(*static_cast<BTreeGeneric*>(&btree)) {}
+   // -------------------------------------------------------------------------------------
+   // >= key
+   OP_RESULT seek(Slice key)
+   {
+      forgetPaused();
+      return position(iterator.seek(key));
+   }
+   // <= key
+   OP_RESULT seekForPrev(Slice key)
+   {
+      forgetPaused();
+      return position(iterator.seekForPrev(key));
+   }
+   OP_RESULT seekExact(Slice key)
+   {
+      forgetPaused();
+      return position(iterator.seekExact(key));
+   }
+   OP_RESULT next()
+   {
+      if (!is_valid) {
+         return OP_RESULT::NOT_FOUND;
+      }
+      resumeIfPaused();
+      if (next_is_current) {
+         return position(OP_RESULT::OK);
+      }
+      return position(iterator.next());
+   }
+   OP_RESULT prev()
+   {
+      if (!is_valid) {
+         return OP_RESULT::NOT_FOUND;
+      }
+      resumeIfPaused();
+      if (prev_is_current) {
+         return position(OP_RESULT::OK);
+      }
+      return position(iterator.prev());
+   }
+   // -------------------------------------------------------------------------------------
+   bool isValid() const { return is_valid; }
+   bool isPaused() const { return is_paused; }
+   Slice key()
+   {
+      assert(is_valid && !is_paused);
+      return iterator.key();
+   }
+   Slice value()
+   {
+      assert(is_valid && !is_paused);
+      return iterator.value();
+   }
+   // -------------------------------------------------------------------------------------
+   // Releases the latches, key() and value() must not be used until the cursor is resumed
+   void pause()
+   {
+      if (is_paused) {
+         return;
+      }
+      if (!is_valid) {
+         iterator.reset();
+         return;
+      }
+      const Slice key = iterator.key();
+      paused_key.assign(key.data(), key.length());
+      // The leaf guard stays optimistic with the version we witnessed, it serves as hint for resume
+      iterator.p_guard.unlock();
+      iterator.leaf.unlock();
+      iterator.leaf_pos_in_parent = -1;
+      is_paused = true;
+   }
+   // OK: positioned on the key we paused on
+   // NOT_FOUND: the key got removed meanwhile, the cursor stands on its successor (or predecessor if there is none),
+   // the following next() (resp. prev()) returns that entry
+   OP_RESULT resume()
+   {
+      if (!is_paused) {
+         return is_valid ? OP_RESULT::OK : OP_RESULT::NOT_FOUND;
+      }
+      is_paused = false;
+      volatile bool relatched = false;
+      jumpmuTry()
+      {
+         iterator.leaf.toShared();
+         relatched = true;
+      }
+      jumpmuCatch() {}
+      if (relatched) {
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_cursor_resume_hint[iterator.btree.dt_id]++; }
+         iterator.prefix_copied = false;
+         iterator.assembleKey();
+         return OP_RESULT::OK;
+      }
+      // The leaf changed, seek the key again
+      iterator.reset();
+      const Slice key(paused_key.data(), paused_key.length());
+      if (iterator.seek(key) == OP_RESULT::OK) {
+         iterator.assembleKey();
+         if (iterator.key() == key) {
+            return position(OP_RESULT::OK);
+         }
+         position(OP_RESULT::OK);
+         next_is_current = true;
+         return OP_RESULT::NOT_FOUND;
+      }
+      if (position(iterator.seekForPrev(key)) == OP_RESULT::OK) {
+         prev_is_current = true;
+      }
+      return OP_RESULT::NOT_FOUND;
+   }
+};
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
@@ -161,17 +161,165 @@ OP_RESULT BTreeLL::insert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_
       BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
       OP_RESULT ret = iterator.insertKV(key, value);
       ensure(ret == OP_RESULT::OK);
+      logInsert(iterator, key, value);
+      jumpmu_return OP_RESULT::OK;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+void BTreeLL::logInsert(BTreeExclusiveIterator& iterator, Slice key, Slice value)
+{
+   if (config.enable_wal) {
+      auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(key.length() + value.length());
+      wal_entry->type = WAL_LOG_TYPE::WALInsert;
+      wal_entry->key_length = key.length();
+      wal_entry->value_length = value.length();
+      std::memcpy(wal_entry->payload, key.data(), key.length());
+      std::memcpy(wal_entry->payload + key.length(), value.data(), value.length());
+      wal_entry.submit();
+   } else {
+      iterator.markAsDirty();
+   }
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::insertSorted(const std::vector<std::pair<Slice, Slice>>& kvs)
+{
+   cr::activeTX().markAsWrite();
+   u64 kv_i = 0;
+   while (kv_i < kvs.size()) {
       if (config.enable_wal) {
-         auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(key.length() + value.length());
-         wal_entry->type = WAL_LOG_TYPE::WALInsert;
-         wal_entry->key_length = key.length();
-         wal_entry->value_length = value.length();
-         std::memcpy(wal_entry->payload, key.data(), key.length());
-         std::memcpy(wal_entry->payload + key.length(), value.data(), value.length());
-         wal_entry.submit();
-      } else {
-         iterator.markAsDirty();
+         cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+      }
+      jumpmuTry()
+      {
+         // One round per leaf: the keys that stay within its fences are inserted without another descent
+         BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+         const u64 run_begin = kv_i;
+         u64 wal_length = 0;
+         OP_RESULT ret = OP_RESULT::OK;
+         bool split = false;
+         while (kv_i < kvs.size()) {
+            const auto& [key, value] = kvs[kv_i];
+            if (kv_i > run_begin && (!iterator.keyInCurrentBoundaries(key) || wal_length + insertBatchEntryLength(key, value) > PAGE_SIZE)) {
+               break;
+            }
+            ret = iterator.seekToInsert(key);
+            if (ret != OP_RESULT::OK) {
+               break;
+            }
+            if (iterator.enoughSpaceInCurrentNode(key, value.length()) == OP_RESULT::NOT_ENOUGH_SPACE) {
+               // Log the run first, the next round splits
+               split = (kv_i == run_begin);
+               break;
+            }
+            iterator.insertInCurrentNode(key, value);
+            wal_length += insertBatchEntryLength(key, value);
+            kv_i++;
+         }
+         if (kv_i > run_begin) {
+            if (config.enable_wal) {
+               logInsertBatch(iterator, kvs, run_begin, kv_i, wal_length);
+            } else {
+               iterator.markAsDirty();
+            }
+         }
+         if (split) {
+            iterator.splitForKey(kvs[kv_i].first);
+         }
+         if (ret != OP_RESULT::OK) {
+            jumpmu_return ret;
+         }
+      }
+      jumpmuCatch()
+      {
+         UNREACHABLE();
+      }
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+void BTreeLL::logInsertBatch(BTreeExclusiveIterator& iterator, const std::vector<std::pair<Slice, Slice>>& kvs, u64 begin, u64 end, u64 wal_length)
+{
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALInsertBatch>(wal_length);
+   wal_entry->type = WAL_LOG_TYPE::WALInsertBatch;
+   wal_entry->count = end - begin;
+   u8* wal_ptr = wal_entry->payload;
+   for (u64 kv_i = begin; kv_i < end; kv_i++) {
+      const auto& [key, value] = kvs[kv_i];
+      const u16 lengths[2] = {static_cast<u16>(key.length()), static_cast<u16>(value.length())};
+      std::memcpy(wal_ptr, lengths, sizeof(lengths));
+      wal_ptr += sizeof(lengths);
+      std::memcpy(wal_ptr, key.data(), key.length());
+      wal_ptr += key.length();
+      std::memcpy(wal_ptr, value.data(), value.length());
+      wal_ptr += value.length();
+   }
+   wal_entry.submit();
+}
+// -------------------------------------------------------------------------------------
+void BTreeLL::prefetch(const std::vector<Slice>& keys)
+{
+   for (const auto& key : keys) {
+      BTreeGeneric::prefetch(key.data(), key.length());
+   }
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::upsert(u8* o_key, u16 o_key_length, u8* o_value, u16 o_value_length)
+{
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   const Slice key(o_key, o_key_length);
+   const Slice value(o_value, o_value_length);
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.insertKV(key, value);
+      if (ret == OP_RESULT::DUPLICATE) {
+         // insertKV left the iterator on the existing key, replace its value without a second descent
+         jumpmu_return updateVariableSizeAt(
+             iterator, key,
+             [&](u16, u16& new_value_length) {
+                new_value_length = value.length();
+                return true;
+             },
+             [&](const u8*, u16, u8* new_value, u16) { std::memcpy(new_value, value.data(), value.length()); });
+      }
+      ensure(ret == OP_RESULT::OK);
+      logInsert(iterator, key, value);
+      jumpmu_return OP_RESULT::OK;
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::merge(u8* o_key,
+                         u16 o_key_length,
+                         u8* o_operand,
+                         u16 o_operand_length,
+                         function<void(u8* value, u16 value_length)> merge_fn,
+                         UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   const Slice key(o_key, o_key_length);
+   const Slice operand(o_operand, o_operand_length);
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.insertKV(key, operand);
+      if (ret == OP_RESULT::DUPLICATE) {
+         updateSameSizeInPlaceAt(iterator, key, merge_fn, update_descriptor);
+         jumpmu_return OP_RESULT::OK;
       }
+      ensure(ret == OP_RESULT::OK);
+      logInsert(iterator, key, operand);
       jumpmu_return OP_RESULT::OK;
    }
    jumpmuCatch() {}
@@ -376,30 +524,7 @@ OP_RESULT BTreeLL::updateSameSizeInPlace(u8* o_key,
       if (ret != OP_RESULT::OK) {
          jumpmu_return ret;
       }
-      auto current_value = iterator.mutableValue();
-      if (config.enable_wal) {
-         assert(update_descriptor.count > 0);  // if it is a secondary index, then we can not use updateSameSize
-         // -------------------------------------------------------------------------------------
-         const u16 delta_length = update_descriptor.size() + update_descriptor.diffLength();
-         auto wal_entry = iterator.leaf.reserveWALEntry<WALUpdate>(key.length() + delta_length);
-         wal_entry->type = WAL_LOG_TYPE::WALUpdate;
-         wal_entry->key_length = key.length();
-         wal_entry->delta_length = delta_length;
-         u8* wal_ptr = wal_entry->payload;
-         std::memcpy(wal_ptr, key.data(), key.length());
-         wal_ptr += key.length();
-         std::memcpy(wal_ptr, &update_descriptor, update_descriptor.size());
-         wal_ptr += update_descriptor.size();
-         generateDiff(update_descriptor, wal_ptr, current_value.data());
-         // The actual update by the client
-         callback(current_value.data(), current_value.length());
-         generateXORDiff(update_descriptor, wal_ptr, current_value.data());
-         wal_entry.submit();
-      } else {
-         callback(current_value.data(), current_value.length());
-         iterator.markAsDirty();
-      }
-      iterator.contentionSplit();
+      updateSameSizeInPlaceAt(iterator, key, callback, update_descriptor);
       jumpmu_return OP_RESULT::OK;
    }
    jumpmuCatch() {}
@@ -407,6 +532,104 @@ OP_RESULT BTreeLL::updateSameSizeInPlace(u8* o_key,
    return OP_RESULT::OTHER;
 }
 // -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::updateVariableSize(u8* o_key,
+                                      u16 o_key_length,
+                                      function<bool(u16, u16&)> new_value_length_for,
+                                      function<void(const u8*, u16, u8*, u16)> callback)
+{
+   cr::activeTX().markAsWrite();
+   if (config.enable_wal) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   }
+   Slice key(o_key, o_key_length);
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      auto ret = iterator.seekExact(key);
+      if (ret != OP_RESULT::OK) {
+         jumpmu_return ret;
+      }
+      jumpmu_return updateVariableSizeAt(iterator, key, new_value_length_for, callback);
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+void BTreeLL::updateSameSizeInPlaceAt(BTreeExclusiveIterator& iterator,
+                                      Slice key,
+                                      function<void(u8* payload, u16 payload_size)> callback,
+                                      UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   auto current_value = iterator.mutableValue();
+   if (config.enable_wal) {
+      assert(update_descriptor.count > 0);  // if it is a secondary index, then we can not use updateSameSize
+      // -------------------------------------------------------------------------------------
+      const u16 delta_length = update_descriptor.size() + update_descriptor.diffLength();
+      auto wal_entry = iterator.leaf.reserveWALEntry<WALUpdate>(key.length() + delta_length);
+      wal_entry->type = WAL_LOG_TYPE::WALUpdate;
+      wal_entry->key_length = key.length();
+      wal_entry->delta_length = delta_length;
+      u8* wal_ptr = wal_entry->payload;
+      std::memcpy(wal_ptr, key.data(), key.length());
+      wal_ptr += key.length();
+      std::memcpy(wal_ptr, &update_descriptor, update_descriptor.size());
+      wal_ptr += update_descriptor.size();
+      generateDiff(update_descriptor, wal_ptr, current_value.data());
+      // The actual update by the client
+      callback(current_value.data(), current_value.length());
+      generateXORDiff(update_descriptor, wal_ptr, current_value.data());
+      wal_entry.submit();
+   } else {
+      callback(current_value.data(), current_value.length());
+      iterator.markAsDirty();
+   }
+   iterator.contentionSplit();
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeLL::updateVariableSizeAt(BTreeExclusiveIterator& iterator,
+                                        Slice key,
+                                        function<bool(u16, u16&)> new_value_length_for,
+                                        function<void(const u8*, u16, u8*, u16)> callback)
+{
+   const u16 value_length = iterator.value().length();
+   u16 new_value_length;
+   if (!new_value_length_for(value_length, new_value_length)) {
+      return OP_RESULT::OTHER;
+   }
+   // Resizing moves the payload without its content
+   u8 value[value_length];
+   std::memcpy(value, iterator.value().data(), value_length);
+   if (new_value_length > value_length) {
+      if (!iterator.extendPayload(new_value_length)) {
+         return OP_RESULT::NOT_ENOUGH_SPACE;
+      }
+   } else if (new_value_length < value_length) {
+      iterator.shorten(new_value_length);
+   }
+   u8* new_value = iterator.mutableValue().data();
+   callback(value, value_length, new_value, new_value_length);
+   if (config.enable_wal) {
+      const SpliceRange range = generateSplice(value, value_length, new_value, new_value_length);
+      auto wal_entry = iterator.leaf.reserveWALEntry<WALSplice>(key.length() + range.before_length + range.after_length);
+      wal_entry->type = WAL_LOG_TYPE::WALSplice;
+      wal_entry->key_length = key.length();
+      wal_entry->offset = range.offset;
+      wal_entry->before_length = range.before_length;
+      wal_entry->after_length = range.after_length;
+      std::memcpy(wal_entry->payload, key.data(), key.length());
+      std::memcpy(wal_entry->payload + key.length(), value + range.offset, range.before_length);
+      std::memcpy(wal_entry->payload + key.length() + range.before_length, new_value + range.offset, range.after_length);
+      wal_entry.submit();
+   } else {
+      iterator.markAsDirty();
+   }
+   if (new_value_length < value_length) {
+      iterator.mergeIfNeeded();
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
 OP_RESULT BTreeLL::remove(u8* o_key, u16 o_key_length)
 {
    cr::activeTX().markAsWrite();
@@ -643,6 +866,20 @@ void BTreeLL::applyXORDiff(const UpdateSameSizeInPlaceDescriptor& update_descrip
    }
 }
 // -------------------------------------------------------------------------------------
+BTreeLL::SpliceRange BTreeLL::generateSplice(const u8* before, u16 before_length, const u8* after, u16 after_length)
+{
+   const u16 common_length = std::min(before_length, after_length);
+   u16 prefix_length = 0;
+   while (prefix_length < common_length && before[prefix_length] == after[prefix_length]) {
+      prefix_length++;
+   }
+   u16 suffix_length = 0;
+   while (suffix_length < common_length - prefix_length && before[before_length - 1 - suffix_length] == after[after_length - 1 - suffix_length]) {
+      suffix_length++;
+   }
+   return {prefix_length, static_cast<u16>(before_length - prefix_length - suffix_length), static_cast<u16>(after_length - prefix_length - suffix_length)};
+}
+// -------------------------------------------------------------------------------------
 }  // namespace btree
 }  // namespace storage
 }  // namespace leanstore
@@ -18,6 +18,8 @@ namespace storage
 namespace btree
 {
 // -------------------------------------------------------------------------------------
+class BTreeExclusiveIterator;
+// -------------------------------------------------------------------------------------
 class BTreeLL : public KVInterface, public BTreeGeneric
 {
   public:
@@ -44,6 +46,20 @@ class BTreeLL : public KVInterface, public BTreeGeneric
       u16 value_length;
       u8 payload[];
    };
+   // Variable-size update: before and after share everything outside [offset, offset + before_length/after_length)
+   struct WALSplice : WALEntry {
+      u16 key_length;
+      u16 offset;
+      u16 before_length;
+      u16 after_length;
+      u8 payload[];  // key | before | after
+   };
+   // Run of inserts into one leaf, undone on abort like WALInsert, there is no redo of it (nor of any entry) in this tree yet
+   struct WALInsertBatch : WALEntry {
+      u16 count;
+      u8 payload[];  // count times: key_length | value_length | key | value
+   };
+   static constexpr u64 insertBatchEntryLength(Slice key, Slice value) { return 2 * sizeof(u16) + key.length() + value.length(); }
    // -------------------------------------------------------------------------------------
    BTreeLL() = default;
    // -------------------------------------------------------------------------------------
@@ -54,6 +70,20 @@ class BTreeLL : public KVInterface, public BTreeGeneric
                                            function<void(u8* value, u16 value_size)>,
                                            UpdateSameSizeInPlaceDescriptor&) override;
    virtual OP_RESULT remove(u8* key, u16 key_length) override;
+   using KVInterface::updateVariableSize;
+   virtual OP_RESULT updateVariableSize(u8* key,
+                                        u16 key_length,
+                                        function<bool(u16 value_length, u16& new_value_length)>,
+                                        function<void(const u8* value, u16 value_length, u8* new_value, u16 new_value_length)>) override;
+   virtual OP_RESULT insertSorted(const std::vector<std::pair<Slice, Slice>>& kvs) override;
+   virtual void prefetch(const std::vector<Slice>& keys) override;
+   virtual OP_RESULT upsert(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   virtual OP_RESULT merge(u8* key,
+                           u16 key_length,
+                           u8* operand,
+                           u16 operand_length,
+                           function<void(u8* value, u16 value_length)> merge_fn,
+                           UpdateSameSizeInPlaceDescriptor&) override;
    virtual OP_RESULT scanAsc(u8* start_key,
                              u16 key_length,
                              function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
@@ -90,6 +120,25 @@ class BTreeLL : public KVInterface, public BTreeGeneric
    static void applyDiff(const UpdateSameSizeInPlaceDescriptor& update_descriptor, u8* dst, const u8* src);
    static void generateXORDiff(const UpdateSameSizeInPlaceDescriptor& update_descriptor, u8* dst, const u8* src);
    static void applyXORDiff(const UpdateSameSizeInPlaceDescriptor& update_descriptor, u8* dst, const u8* src);
+   struct SpliceRange {
+      u16 offset, before_length, after_length;
+   };
+   // Trims the common prefix and suffix of before and after
+   static SpliceRange generateSplice(const u8* before, u16 before_length, const u8* after, u16 after_length);
+   // One WALInsertBatch for kvs[begin, end), which were inserted into the leaf of the iterator
+   void logInsertBatch(BTreeExclusiveIterator& iterator, const std::vector<std::pair<Slice, Slice>>& kvs, u64 begin, u64 end, u64 wal_length);
+
+  private:
+   // Write paths on an iterator that is already positioned on the key
+   void logInsert(BTreeExclusiveIterator& iterator, Slice key, Slice value);
+   void updateSameSizeInPlaceAt(BTreeExclusiveIterator& iterator,
+                                Slice key,
+                                function<void(u8* value, u16 value_size)>,
+                                UpdateSameSizeInPlaceDescriptor&);
+   OP_RESULT updateVariableSizeAt(BTreeExclusiveIterator& iterator,
+                                  Slice key,
+                                  function<bool(u16 value_length, u16& new_value_length)>,
+                                  function<void(const u8* value, u16 value_length, u8* new_value, u16 new_value_length)>);
 };
 // -------------------------------------------------------------------------------------
 }  // namespace btree
@@ -91,16 +91,22 @@ OP_RESULT BTreeVI::lookupOptimistic(const u8* key, const u16 key_length, functio
             auto tuple_head = *reinterpret_cast<Tuple*>(leaf->getPayload(pos));
             leaf.recheck();
             if (isVisibleForMe(tuple_head.worker_id, tuple_head.tx_ts, false)) {
-               u32 offset = 0;
+               u32 offset = 0, trailer = 0;
                if (tuple_head.tuple_format == TupleFormat::CHAINED) {
+                  if (reinterpret_cast<const ChainedTuple*>(leaf->getPayload(pos))->is_removed) {
+                     leaf.recheck();
+                     jumpmu_return OP_RESULT::NOT_FOUND;
+                  }
                   offset = sizeof(ChainedTuple);
+                  trailer = reinterpret_cast<const ChainedTuple*>(leaf->getPayload(pos))->inlineLength(leaf->getPayloadLength(pos));
                } else if (tuple_head.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES) {
                   offset = sizeof(FatTupleDifferentAttributes);
                } else {
                   leaf.recheck();
                   UNREACHABLE();
                }
-               payload_callback(leaf->getPayload(pos) + offset, leaf->getPayloadLength(pos) - offset);
+               leaf.recheck();
+               payload_callback(leaf->getPayload(pos) + offset, leaf->getPayloadLength(pos) - offset - trailer);
                leaf.recheck();
                COUNTERS_BLOCK()
                {
@@ -209,7 +215,7 @@ OP_RESULT BTreeVI::executeDeterministricUpdate(u8* o_key,
       std::memcpy(wal_entry->payload, o_key, o_key_length);
       std::memcpy(wal_entry->payload + o_key_length, &update_descriptor, update_descriptor.size());
       BTreeLL::generateDiff(update_descriptor, wal_entry->payload + o_key_length + update_descriptor.size(), tuple_head.payload);
-      callback(tuple_head.payload, primary_payload.length() - sizeof(ChainedTuple));  // Update
+      callback(tuple_head.payload, tuple_head.valueLength(primary_payload.length()));  // Update
       BTreeLL::generateXORDiff(update_descriptor, wal_entry->payload + o_key_length + update_descriptor.size(), tuple_head.payload);
       wal_entry.submit();
       // -------------------------------------------------------------------------------------
@@ -221,6 +227,7 @@ OP_RESULT BTreeVI::executeDeterministricUpdate(u8* o_key,
       // -------------------------------------------------------------------------------------
       tuple_head.unlock();
       iterator.markAsDirty();
+      invalidateColdReplica(key);
       iterator.contentionSplit();
       // -------------------------------------------------------------------------------------
       jumpmu_return OP_RESULT::OK;
@@ -229,6 +236,56 @@ OP_RESULT BTreeVI::executeDeterministricUpdate(u8* o_key,
    UNREACHABLE();
 }
 // -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::updateDeterministic(u8* o_key,
+                                       u16 o_key_length,
+                                       function<void(u8* value, u16 value_size)> callback,
+                                       UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   cr::activeTX().markAsWrite();
+   Slice key(o_key, o_key_length);
+   bool is_chained = true;
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.seekExact(key);
+      if (ret != OP_RESULT::OK) {
+         jumpmu_return ret;
+      }
+      MutableSlice primary_payload = iterator.mutableValue();
+      auto& tuple_head = *reinterpret_cast<ChainedTuple*>(primary_payload.data());
+      if (tuple_head.tuple_format == TupleFormat::CHAINED) {
+         if (tuple_head.is_removed) {
+            jumpmu_return OP_RESULT::NOT_FOUND;
+         }
+         // Only this worker touches the key during the batch, anything else is a caller breaking the exclusivity precondition
+         ensure(!tuple_head.isWriteLocked() && isVisibleForMe(tuple_head.worker_id, tuple_head.tx_ts, true));
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().cc_update_chains[dt_id]++;
+         }
+         if (FLAGS_wal) {
+            if (!FLAGS_wal_tuple_rfa) {
+               iterator.leaf.incrementGSN();
+            }
+            cr::Worker::my().logging.checkLogDepdency(tuple_head.worker_id, tuple_head.tx_ts);
+         }
+         callback(tuple_head.payload, tuple_head.valueLength(primary_payload.length()));
+         // No before-image: snapshots that can not see the batch yet abort when they reach this head (reconstructChainedTuple)
+         tuple_head.worker_id = cr::Worker::my().workerID();
+         tuple_head.tx_ts = cr::activeTX().startTS();
+         tuple_head.command_id = Tuple::BATCH_COMMANDID;
+         iterator.markAsDirty();
+         invalidateColdReplica(key);
+         jumpmu_return OP_RESULT::OK;
+      }
+      is_chained = false;
+   }
+   jumpmuCatch() {}
+   // Fat tuples keep their deltas in place, take the regular path for them
+   ensure(!is_chained);
+   return updateSameSizeInPlace(o_key, o_key_length, callback, update_descriptor);
+}
+// -------------------------------------------------------------------------------------
 OP_RESULT BTreeVI::updateSameSizeInPlace(u8* o_key,
                                          u16 o_key_length,
                                          function<void(u8* value, u16 value_size)> callback,
@@ -257,140 +314,364 @@ OP_RESULT BTreeVI::updateSameSizeInPlace(u8* o_key,
       }
       // -------------------------------------------------------------------------------------
       // Record is found
-   restart : {
-      MutableSlice primary_payload = iterator.mutableValue();
-      auto& tuple = *reinterpret_cast<Tuple*>(primary_payload.data());
-      if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
-         jumpmu_return OP_RESULT::ABORT_TX;
-      }
-      tuple.writeLock();
-      COUNTERS_BLOCK()
-      {
-         WorkerCounters::myCounters().cc_update_chains[dt_id]++;
-      }
+      jumpmu_return updateSameSizeInPlaceAt(iterator, o_key, o_key_length, callback, update_descriptor);
+   }
+   jumpmuCatch() {}
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::updateSameSizeInPlaceAt(BTreeExclusiveIterator& iterator,
+                                           u8* o_key,
+                                           u16 o_key_length,
+                                           function<void(u8* value, u16 value_size)> callback,
+                                           UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   Slice key(o_key, o_key_length);
+restart : {
+   MutableSlice primary_payload = iterator.mutableValue();
+   auto& tuple = *reinterpret_cast<Tuple*>(primary_payload.data());
+   if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
+      return OP_RESULT::ABORT_TX;
+   }
+   tuple.writeLock();
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().cc_update_chains[dt_id]++;
+   }
+   // -------------------------------------------------------------------------------------
+   if (tuple.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES) {
+      const bool res = reinterpret_cast<FatTupleDifferentAttributes*>(&tuple)->update(iterator, o_key, o_key_length, callback, update_descriptor);
+      reinterpret_cast<Tuple*>(iterator.mutableValue().data())->unlock();
+      // Attention: tuple pointer is not valid here
       // -------------------------------------------------------------------------------------
-      if (tuple.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES) {
-         const bool res = reinterpret_cast<FatTupleDifferentAttributes*>(&tuple)->update(iterator, o_key, o_key_length, callback, update_descriptor);
-         reinterpret_cast<Tuple*>(iterator.mutableValue().data())->unlock();
-         // Attention: tuple pointer is not valid here
-         // -------------------------------------------------------------------------------------
-         iterator.markAsDirty();
-         iterator.contentionSplit();
-         // -------------------------------------------------------------------------------------
-         if (!res) {
-            // Converted back to chained -> restart
-            goto restart;
-         }
-         // -------------------------------------------------------------------------------------
-         jumpmu_return OP_RESULT::OK;
+      iterator.markAsDirty();
+      invalidateColdReplica(key);
+      iterator.contentionSplit();
+      // -------------------------------------------------------------------------------------
+      if (!res) {
+         // Converted back to chained -> restart
+         goto restart;
       }
       // -------------------------------------------------------------------------------------
-      auto& tuple_head = *reinterpret_cast<ChainedTuple*>(primary_payload.data());
-      if (FLAGS_vi_fat_tuple) {
-         bool convert_to_fat_tuple = tuple_head.command_id != Tuple::INVALID_COMMANDID &&
-                                     cr::Worker::global_oldest_oltp_start_ts != cr::Worker::global_oldest_all_start_ts &&
-                                     !(tuple_head.worker_id == cr::Worker::my().workerID() && tuple_head.tx_ts == cr::activeTX().startTS());
+      return OP_RESULT::OK;
+   }
+   // -------------------------------------------------------------------------------------
+   auto& tuple_head = *reinterpret_cast<ChainedTuple*>(primary_payload.data());
+   if (FLAGS_vi_fat_tuple) {
+      bool convert_to_fat_tuple = tuple_head.command_id != Tuple::INVALID_COMMANDID &&
+                                  cr::Worker::my().global.oldest_oltp_start_ts != cr::Worker::my().global.oldest_all_start_ts &&
+                                  !(tuple_head.worker_id == cr::Worker::my().workerID() && tuple_head.tx_ts == cr::activeTX().startTS());
 
-         // -------------------------------------------------------------------------------------
-         if (FLAGS_vi_fat_tuple_trigger == 0) {
-            if (cr::Worker::my().cc.isVisibleForAll(tuple_head.worker_id, tuple_head.tx_ts)) {
-               tuple_head.oldest_tx = 0;
-               tuple_head.updates_counter = 0;
-               convert_to_fat_tuple = false;
+      // -------------------------------------------------------------------------------------
+      if (FLAGS_vi_fat_tuple_trigger == 0) {
+         if (cr::Worker::my().cc.isVisibleForAll(tuple_head.worker_id, tuple_head.tx_ts)) {
+            tuple_head.oldest_tx = 0;
+            tuple_head.updates_counter = 0;
+            convert_to_fat_tuple = false;
+         } else {
+            if (tuple_head.oldest_tx == static_cast<u16>(cr::Worker::my().global.oldest_all_start_ts & 0xFFFF)) {
+               tuple_head.updates_counter++;
             } else {
-               if (tuple_head.oldest_tx == static_cast<u16>(cr::Worker::global_oldest_all_start_ts & 0xFFFF)) {
-                  tuple_head.updates_counter++;
-               } else {
-                  tuple_head.oldest_tx = static_cast<u16>(cr::Worker::global_oldest_all_start_ts & 0xFFFF);
-                  tuple_head.updates_counter = 0;
-               }
+               tuple_head.oldest_tx = static_cast<u16>(cr::Worker::my().global.oldest_all_start_ts & 0xFFFF);
+               tuple_head.updates_counter = 0;
             }
-            convert_to_fat_tuple &= tuple_head.updates_counter > convertToFatTupleThreshold();
-         } else if (FLAGS_vi_fat_tuple_trigger == 1) {
-            convert_to_fat_tuple &= utils::RandomGenerator::getRandU64(0, convertToFatTupleThreshold()) == 0;
-         } else {
-            UNREACHABLE();
          }
-         // -------------------------------------------------------------------------------------
-         if (convert_to_fat_tuple) {
+         convert_to_fat_tuple &= tuple_head.updates_counter > convertToFatTupleThreshold();
+      } else if (FLAGS_vi_fat_tuple_trigger == 1) {
+         convert_to_fat_tuple &= utils::RandomGenerator::getRandU64(0, convertToFatTupleThreshold()) == 0;
+      } else {
+         UNREACHABLE();
+      }
+      // -------------------------------------------------------------------------------------
+      if (convert_to_fat_tuple) {
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().cc_fat_tuple_triggered[dt_id]++;
+         }
+         tuple_head.updates_counter = 0;
+         const bool convert_ret = convertChainedToFatTupleDifferentAttributes(iterator);
+         if (convert_ret) {
+            iterator.leaf->has_garbage = true;
             COUNTERS_BLOCK()
             {
-               WorkerCounters::myCounters().cc_fat_tuple_triggered[dt_id]++;
-            }
-            tuple_head.updates_counter = 0;
-            const bool convert_ret = convertChainedToFatTupleDifferentAttributes(iterator);
-            if (convert_ret) {
-               iterator.leaf->has_garbage = true;
-               COUNTERS_BLOCK()
-               {
-                  WorkerCounters::myCounters().cc_fat_tuple_convert[dt_id]++;
-               }
+               WorkerCounters::myCounters().cc_fat_tuple_convert[dt_id]++;
             }
-            goto restart;
-            UNREACHABLE();
          }
-      } else if (FLAGS_vi_fat_tuple_alternative) {
-         if (!cr::Worker::my().cc.isVisibleForAll(tuple_head.worker_id, tuple_head.tx_ts)) {
-            cr::Worker::my().cc.retrieveVersion(tuple_head.worker_id, tuple_head.tx_ts, tuple_head.command_id, [&](const u8* version_payload, u64) {
-               auto& version = *reinterpret_cast<const Version*>(version_payload);
-               cr::Worker::my().cc.retrieveVersion(version.worker_id, version.tx_id, version.command_id, [&](const u8*, u64) {});
-            });
+         goto restart;
+         UNREACHABLE();
+      }
+   } else if (FLAGS_vi_fat_tuple_alternative) {
+      if (!cr::Worker::my().cc.isVisibleForAll(tuple_head.worker_id, tuple_head.tx_ts)) {
+         cr::Worker::my().cc.retrieveVersion(tuple_head.worker_id, tuple_head.tx_ts, tuple_head.command_id, [&](const u8* version_payload, u64) {
+            auto& version = *reinterpret_cast<const Version*>(version_payload);
+            cr::Worker::my().cc.retrieveVersion(version.worker_id, version.tx_id, version.command_id, [&](const u8*, u64) {});
+         });
+      }
+   }
+   // -------------------------------------------------------------------------------------
+}
+   // Update in chained mode
+   MutableSlice primary_payload = iterator.mutableValue();
+   auto& tuple_head = *reinterpret_cast<ChainedTuple*>(primary_payload.data());
+   const u16 delta_and_descriptor_size = update_descriptor.size() + update_descriptor.diffLength();
+   const u16 version_payload_length = delta_and_descriptor_size + sizeof(UpdateVersion);
+   COMMANDID command_id = Tuple::INVALID_COMMANDID;
+   // -------------------------------------------------------------------------------------
+   // Version elision: when the before-image is visible for all (below the global LWM), no snapshot needs anything older.
+   // Only the transactions that overlap with ours may still read the before-image, they abort (reconstructChainedTuple).
+   // With a single worker there is no such transaction. Undo uses the WAL only
+   const bool elide_version = cr::activeTX().canUseSingleVersion() && !FLAGS_vi_fat_tuple && !FLAGS_vi_fat_tuple_alternative &&
+                              cr::Worker::my().cc.isVisibleForAll(tuple_head.worker_id, tuple_head.tx_ts);
+   // Copy of the version for the inline versions
+   const bool keep_inline = FLAGS_vi_inline_versions && version_payload_length <= FLAGS_vi_inline_version_max_length;
+   u8 inline_version[keep_inline ? version_payload_length : 1];
+   // -------------------------------------------------------------------------------------
+   // Write the ChainedTupleDelta
+   if (elide_version) {
+      command_id = Tuple::ELIDED_COMMANDID;
+      COUNTERS_BLOCK()
+      {
+         WorkerCounters::myCounters().cc_update_versions_elided[dt_id]++;
+      }
+   } else if (!FLAGS_vi_fupdate_chained) {
+      command_id = cr::Worker::my().cc.insertVersion(dt_id, false, version_payload_length, [&](u8* version_payload) {
+         auto& secondary_version = *new (version_payload) UpdateVersion(tuple_head.worker_id, tuple_head.tx_ts, tuple_head.command_id, true);
+         std::memcpy(secondary_version.payload, &update_descriptor, update_descriptor.size());
+         BTreeLL::generateDiff(update_descriptor, secondary_version.payload + update_descriptor.size(), tuple_head.payload);
+         if (keep_inline) {
+            std::memcpy(inline_version, version_payload, version_payload_length);
          }
+      });
+      COUNTERS_BLOCK()
+      {
+         WorkerCounters::myCounters().cc_update_versions_created[dt_id]++;
       }
-      // -------------------------------------------------------------------------------------
    }
-      // Update in chained mode
-      MutableSlice primary_payload = iterator.mutableValue();
-      auto& tuple_head = *reinterpret_cast<ChainedTuple*>(primary_payload.data());
-      const u16 delta_and_descriptor_size = update_descriptor.size() + update_descriptor.diffLength();
-      const u16 version_payload_length = delta_and_descriptor_size + sizeof(UpdateVersion);
-      COMMANDID command_id;
-      // -------------------------------------------------------------------------------------
-      // Write the ChainedTupleDelta
-      if (!FLAGS_vi_fupdate_chained) {
-         command_id = cr::Worker::my().cc.insertVersion(dt_id, false, version_payload_length, [&](u8* version_payload) {
-            auto& secondary_version = *new (version_payload) UpdateVersion(tuple_head.worker_id, tuple_head.tx_ts, tuple_head.command_id, true);
-            std::memcpy(secondary_version.payload, &update_descriptor, update_descriptor.size());
-            BTreeLL::generateDiff(update_descriptor, secondary_version.payload + update_descriptor.size(), tuple_head.payload);
-         });
-         COUNTERS_BLOCK()
-         {
-            WorkerCounters::myCounters().cc_update_versions_created[dt_id]++;
+   // -------------------------------------------------------------------------------------
+   // WAL
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALUpdateSSIP>(o_key_length + delta_and_descriptor_size);
+   wal_entry->type = WAL_LOG_TYPE::WALUpdate;
+   wal_entry->key_length = o_key_length;
+   wal_entry->delta_length = delta_and_descriptor_size;
+   wal_entry->before_worker_id = tuple_head.worker_id;
+   wal_entry->before_tx_id = tuple_head.tx_ts;
+   wal_entry->before_command_id = tuple_head.command_id;
+   std::memcpy(wal_entry->payload, o_key, o_key_length);
+   std::memcpy(wal_entry->payload + o_key_length, &update_descriptor, update_descriptor.size());
+   BTreeLL::generateDiff(update_descriptor, wal_entry->payload + o_key_length + update_descriptor.size(), tuple_head.payload);
+   callback(tuple_head.payload, tuple_head.valueLength(primary_payload.length()));  // Update
+   BTreeLL::generateXORDiff(update_descriptor, wal_entry->payload + o_key_length + update_descriptor.size(), tuple_head.payload);
+   wal_entry.submit();
+   // -------------------------------------------------------------------------------------
+   cr::Worker::my().logging.checkLogDepdency(tuple_head.worker_id, tuple_head.tx_ts);
+   // -------------------------------------------------------------------------------------
+   tuple_head.worker_id = cr::Worker::my().workerID();
+   tuple_head.tx_ts = cr::activeTX().startTS();
+   tuple_head.command_id = command_id;
+   // -------------------------------------------------------------------------------------
+   tuple_head.unlock();
+   if (FLAGS_vi_inline_versions) {
+      // Attention: tuple_head is not valid after this
+      const bool version_created = !elide_version && !FLAGS_vi_fupdate_chained;
+      refreshInlineVersions(iterator, (version_created && keep_inline) ? inline_version : nullptr, version_payload_length, !elide_version);
+   }
+   iterator.markAsDirty();
+   invalidateColdReplica(key);
+   iterator.contentionSplit();
+   // -------------------------------------------------------------------------------------
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+void BTreeVI::refreshInlineVersions(BTreeExclusiveIterator& iterator, const u8* version, u16 version_length, bool keep_older)
+{
+   const Slice payload = iterator.value();
+   const auto& head = *reinterpret_cast<const ChainedTuple*>(payload.data());
+   const u16 old_inline_length = head.inlineLength(payload.length());
+   if (version == nullptr && (old_inline_length == 0 || keep_older)) {
+      return;
+   }
+   const u16 value_end = payload.length() - old_inline_length;
+   const u16 old_inline_end = payload.length() - (old_inline_length ? sizeof(u16) : 0);
+   u8 inline_area[old_inline_length + sizeof(InlineVersion) + version_length + sizeof(u16)];
+   u16 inline_length = 0;
+   u64 versions_count = 0;
+   if (version) {
+      auto& inline_version = *reinterpret_cast<InlineVersion*>(inline_area);
+      inline_version.worker_id = head.worker_id;
+      inline_version.tx_ts = head.tx_ts;
+      inline_version.command_id = head.command_id;
+      inline_version.version_length = version_length;
+      std::memcpy(inline_version.version, version, version_length);
+      inline_length += sizeof(InlineVersion) + version_length;
+      versions_count++;
+   }
+   if (keep_older) {
+      for (u16 offset = value_end; offset < old_inline_end && versions_count < FLAGS_vi_inline_versions; versions_count++) {
+         const auto& older = *reinterpret_cast<const InlineVersion*>(payload.data() + offset);
+         const u16 older_length = sizeof(InlineVersion) + older.version_length;
+         std::memcpy(inline_area + inline_length, &older, older_length);
+         inline_length += older_length;
+         offset += older_length;
+      }
+   }
+   if (inline_length) {
+      inline_length += sizeof(u16);
+      *reinterpret_cast<u16*>(inline_area + inline_length - sizeof(u16)) = inline_length;
+   }
+   // -------------------------------------------------------------------------------------
+   // Resizing moves the payload without its content
+   u8 head_and_value[value_end];
+   std::memcpy(head_and_value, payload.data(), value_end);
+   const u16 old_payload_length = payload.length();
+   u16 new_payload_length = value_end + inline_length;
+   if (new_payload_length > old_payload_length && !iterator.extendPayload(new_payload_length)) {
+      // No space left in the leaf, the readers go to the history tree
+      inline_length = 0;
+      new_payload_length = value_end;
+   }
+   if (new_payload_length < old_payload_length) {
+      iterator.shorten(new_payload_length);
+   }
+   u8* new_payload = iterator.mutableValue().data();
+   std::memcpy(new_payload, head_and_value, value_end);
+   std::memcpy(new_payload + value_end, inline_area, inline_length);
+   reinterpret_cast<ChainedTuple*>(new_payload)->has_inline_versions = inline_length > 0;
+}
+// -------------------------------------------------------------------------------------
+const u8* BTreeVI::findInlineVersion(Slice payload, WORKERID worker_id, TXID tx_ts, COMMANDID command_id, u16& version_length)
+{
+   const auto& head = *reinterpret_cast<const ChainedTuple*>(payload.data());
+   const u16 inline_length = head.inlineLength(payload.length());
+   for (u16 offset = payload.length() - inline_length; offset + sizeof(u16) < payload.length();) {
+      const auto& inline_version = *reinterpret_cast<const InlineVersion*>(payload.data() + offset);
+      if (inline_version.command_id == command_id && inline_version.tx_ts == tx_ts && inline_version.worker_id == worker_id) {
+         version_length = inline_version.version_length;
+         return inline_version.version;
+      }
+      offset += sizeof(InlineVersion) + inline_version.version_length;
+   }
+   return nullptr;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::updateVariableSize(u8* o_key,
+                                      u16 o_key_length,
+                                      function<bool(u16, u16&)> new_value_length_for,
+                                      function<void(const u8*, u16, u8*, u16)> callback)
+{
+   cr::activeTX().markAsWrite();
+   cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   Slice key(o_key, o_key_length);
+   jumpmuTry()
+   {
+      BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+      OP_RESULT ret = iterator.seekExact(key);
+      if (ret != OP_RESULT::OK) {
+         if (cr::activeTX().isOLAP() && ret == OP_RESULT::NOT_FOUND) {
+            const bool removed_tuple_found = graveyard->lookup(o_key, o_key_length, [&](const u8*, u16) {}) == OP_RESULT::OK;
+            if (removed_tuple_found) {
+               jumpmu_return OP_RESULT::ABORT_TX;
+            }
          }
+         jumpmu_return ret;
       }
-      // -------------------------------------------------------------------------------------
-      // WAL
-      auto wal_entry = iterator.leaf.reserveWALEntry<WALUpdateSSIP>(o_key_length + delta_and_descriptor_size);
-      wal_entry->type = WAL_LOG_TYPE::WALUpdate;
-      wal_entry->key_length = o_key_length;
-      wal_entry->delta_length = delta_and_descriptor_size;
-      wal_entry->before_worker_id = tuple_head.worker_id;
-      wal_entry->before_tx_id = tuple_head.tx_ts;
-      wal_entry->before_command_id = tuple_head.command_id;
-      std::memcpy(wal_entry->payload, o_key, o_key_length);
-      std::memcpy(wal_entry->payload + o_key_length, &update_descriptor, update_descriptor.size());
-      BTreeLL::generateDiff(update_descriptor, wal_entry->payload + o_key_length + update_descriptor.size(), tuple_head.payload);
-      callback(tuple_head.payload, primary_payload.length() - sizeof(ChainedTuple));  // Update
-      BTreeLL::generateXORDiff(update_descriptor, wal_entry->payload + o_key_length + update_descriptor.size(), tuple_head.payload);
-      wal_entry.submit();
-      // -------------------------------------------------------------------------------------
-      cr::Worker::my().logging.checkLogDepdency(tuple_head.worker_id, tuple_head.tx_ts);
-      // -------------------------------------------------------------------------------------
-      tuple_head.worker_id = cr::Worker::my().workerID();
-      tuple_head.tx_ts = cr::activeTX().startTS();
-      tuple_head.command_id = command_id;
-      // -------------------------------------------------------------------------------------
-      tuple_head.unlock();
-      iterator.markAsDirty();
-      iterator.contentionSplit();
-      // -------------------------------------------------------------------------------------
-      jumpmu_return OP_RESULT::OK;
+      jumpmu_return updateVariableSizeAt(iterator, o_key, o_key_length, new_value_length_for, callback);
    }
    jumpmuCatch() {}
    UNREACHABLE();
    return OP_RESULT::OTHER;
 }
 // -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::updateVariableSizeAt(BTreeExclusiveIterator& iterator,
+                                        u8* o_key,
+                                        u16 o_key_length,
+                                        function<bool(u16, u16&)> new_value_length_for,
+                                        function<void(const u8*, u16, u8*, u16)> callback)
+{
+   Slice key(o_key, o_key_length);
+   const auto& tuple = *reinterpret_cast<const Tuple*>(iterator.value().data());
+   if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
+      return OP_RESULT::ABORT_TX;
+   }
+   if (tuple.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES) {
+      // Fat tuples have a fixed value length, decompose it into a chain first (same as the page-wise GC)
+      auto& fat_tuple = *reinterpret_cast<FatTupleDifferentAttributes*>(iterator.mutableValue().data());
+      const u32 new_length = fat_tuple.value_length + sizeof(ChainedTuple);
+      fat_tuple.convertToChained(dt_id);
+      ensure(new_length < iterator.value().length());
+      iterator.shorten(new_length);
+      iterator.markAsDirty();
+   }
+   const Slice primary_payload = iterator.value();
+   ensure(reinterpret_cast<const Tuple*>(primary_payload.data())->tuple_format == TupleFormat::CHAINED);
+   if (reinterpret_cast<const ChainedTuple*>(primary_payload.data())->is_removed) {
+      return OP_RESULT::NOT_FOUND;
+   }
+   const u16 value_length = reinterpret_cast<const ChainedTuple*>(primary_payload.data())->valueLength(primary_payload.length());
+   u16 new_value_length;
+   if (!new_value_length_for(value_length, new_value_length)) {
+      return OP_RESULT::OTHER;
+   }
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().cc_update_chains[dt_id]++;
+   }
+   // -------------------------------------------------------------------------------------
+   // Resizing moves the payload without its content, keep a copy of head and value
+   u8 old_payload[primary_payload.length()];
+   std::memcpy(old_payload, primary_payload.data(), primary_payload.length());
+   const auto& old_head = *reinterpret_cast<const ChainedTuple*>(old_payload);
+   const u16 new_payload_length = new_value_length + sizeof(ChainedTuple);
+   if (new_payload_length > primary_payload.length()) {
+      if (!iterator.extendPayload(new_payload_length)) {
+         return OP_RESULT::NOT_ENOUGH_SPACE;
+      }
+   } else if (new_payload_length < primary_payload.length()) {
+      iterator.shorten(new_payload_length);
+   }
+   auto& tuple_head = *reinterpret_cast<ChainedTuple*>(iterator.mutableValue().data());
+   std::memcpy(&tuple_head, old_payload, sizeof(ChainedTuple));
+   tuple_head.has_inline_versions = false;  // The full before-image goes to the history tree anyway
+   callback(old_head.payload, value_length, tuple_head.payload, new_value_length);
+   // -------------------------------------------------------------------------------------
+   const COMMANDID command_id = cr::Worker::my().cc.insertVersion(dt_id, false, sizeof(UpdateVersion) + value_length, [&](u8* version_payload) {
+      auto& secondary_version = *new (version_payload) UpdateVersion(old_head.worker_id, old_head.tx_ts, old_head.command_id, false);
+      std::memcpy(secondary_version.payload, old_head.payload, value_length);
+   });
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().cc_update_versions_created[dt_id]++;
+   }
+   // -------------------------------------------------------------------------------------
+   // WAL
+   const SpliceRange range = generateSplice(old_head.payload, value_length, tuple_head.payload, new_value_length);
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALSplice>(o_key_length + range.before_length + range.after_length);
+   wal_entry->type = WAL_LOG_TYPE::WALSplice;
+   wal_entry->key_length = o_key_length;
+   wal_entry->offset = range.offset;
+   wal_entry->before_length = range.before_length;
+   wal_entry->after_length = range.after_length;
+   wal_entry->before_worker_id = old_head.worker_id;
+   wal_entry->before_tx_id = old_head.tx_ts;
+   wal_entry->before_command_id = old_head.command_id;
+   std::memcpy(wal_entry->payload, o_key, o_key_length);
+   std::memcpy(wal_entry->payload + o_key_length, old_head.payload + range.offset, range.before_length);
+   std::memcpy(wal_entry->payload + o_key_length + range.before_length, tuple_head.payload + range.offset, range.after_length);
+   wal_entry.submit();
+   // -------------------------------------------------------------------------------------
+   cr::Worker::my().logging.checkLogDepdency(old_head.worker_id, old_head.tx_ts);
+   // -------------------------------------------------------------------------------------
+   tuple_head.worker_id = cr::Worker::my().workerID();
+   tuple_head.tx_ts = cr::activeTX().startTS();
+   tuple_head.command_id = command_id;
+   // -------------------------------------------------------------------------------------
+   iterator.markAsDirty();
+   invalidateColdReplica(key);
+   iterator.contentionSplit();
+   // -------------------------------------------------------------------------------------
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
 OP_RESULT BTreeVI::insert(u8* o_key, u16 o_key_length, u8* value, u16 value_length)
 {
    cr::activeTX().markAsWrite();
@@ -416,26 +697,254 @@ OP_RESULT BTreeVI::insert(u8* o_key, u16 o_key_length, u8* value, u16 value_leng
             iterator.splitForKey(key);
             jumpmu_continue;
          }
-         // -------------------------------------------------------------------------------------
-         // WAL
-         auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(o_key_length + value_length);
-         wal_entry->type = WAL_LOG_TYPE::WALInsert;
-         wal_entry->key_length = o_key_length;
-         wal_entry->value_length = value_length;
-         std::memcpy(wal_entry->payload, o_key, o_key_length);
-         std::memcpy(wal_entry->payload + o_key_length, value, value_length);
-         wal_entry.submit();
-         // -------------------------------------------------------------------------------------
-         iterator.insertInCurrentNode(key, payload_length);
-         MutableSlice payload = iterator.mutableValue();
-         auto& primary_version = *new (payload.data()) ChainedTuple(cr::Worker::my().workerID(), cr::activeTX().startTS());
-         std::memcpy(primary_version.payload, value, value_length);
-         // -------------------------------------------------------------------------------------
-         if (cr::activeTX().current_tx_mode == TX_MODE::INSTANTLY_VISIBLE_BULK_INSERT) {
-            primary_version.tx_ts = MSB | 0;
+         insertAt(iterator, o_key, o_key_length, value, value_length);
+         jumpmu_return OP_RESULT::OK;
+      }
+      jumpmuCatch()
+      {
+         UNREACHABLE();
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+void BTreeVI::insertAt(BTreeExclusiveIterator& iterator, u8* o_key, u16 o_key_length, u8* value, u16 value_length)
+{
+   Slice key(o_key, o_key_length);
+   const u16 payload_length = value_length + sizeof(ChainedTuple);
+   // -------------------------------------------------------------------------------------
+   // WAL
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALInsert>(o_key_length + value_length);
+   wal_entry->type = WAL_LOG_TYPE::WALInsert;
+   wal_entry->key_length = o_key_length;
+   wal_entry->value_length = value_length;
+   std::memcpy(wal_entry->payload, o_key, o_key_length);
+   std::memcpy(wal_entry->payload + o_key_length, value, value_length);
+   wal_entry.submit();
+   // -------------------------------------------------------------------------------------
+   iterator.insertInCurrentNode(key, payload_length);
+   MutableSlice payload = iterator.mutableValue();
+   auto& primary_version = *new (payload.data()) ChainedTuple(cr::Worker::my().workerID(), cr::activeTX().startTS());
+   std::memcpy(primary_version.payload, value, value_length);
+   // -------------------------------------------------------------------------------------
+   if (cr::activeTX().current_tx_mode == TX_MODE::INSTANTLY_VISIBLE_BULK_INSERT) {
+      primary_version.tx_ts = MSB | 0;
+   }
+   // -------------------------------------------------------------------------------------
+   iterator.markAsDirty();
+   invalidateColdReplica(key);
+}
+// -------------------------------------------------------------------------------------
+// The slot of the removed tuple is reused: the head gets the new value and a version that says the tuple was removed,
+// snapshots older than the remove still reach the RemoveVersion behind it. The todo of the remove skips the new head
+OP_RESULT BTreeVI::reinsertAt(BTreeExclusiveIterator& iterator, u8* o_key, u16 o_key_length, u8* value, u16 value_length)
+{
+   Slice key(o_key, o_key_length);
+   const Slice primary_payload = iterator.value();
+   const ChainedTuple old_head = *reinterpret_cast<const ChainedTuple*>(primary_payload.data());
+   ensure(old_head.tuple_format == TupleFormat::CHAINED && old_head.is_removed);
+   const u16 payload_length = value_length + sizeof(ChainedTuple);
+   if (payload_length > primary_payload.length()) {
+      if (!iterator.extendPayload(payload_length)) {
+         return OP_RESULT::NOT_ENOUGH_SPACE;
+      }
+   } else if (payload_length < primary_payload.length()) {
+      iterator.shorten(payload_length);
+   }
+   // -------------------------------------------------------------------------------------
+   const COMMANDID command_id = cr::Worker::my().cc.insertVersion(dt_id, false, sizeof(UpdateVersion), [&](u8* version_payload) {
+      new (version_payload) UpdateVersion(old_head.worker_id, old_head.tx_ts, old_head.command_id, false, true);
+   });
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().cc_update_versions_created[dt_id]++;
+   }
+   // -------------------------------------------------------------------------------------
+   // WAL
+   auto wal_entry = iterator.leaf.reserveWALEntry<WALReinsert>(o_key_length + value_length);
+   wal_entry->type = WAL_LOG_TYPE::WALReinsert;
+   wal_entry->key_length = o_key_length;
+   wal_entry->value_length = value_length;
+   wal_entry->before_worker_id = old_head.worker_id;
+   wal_entry->before_tx_id = old_head.tx_ts;
+   wal_entry->before_command_id = old_head.command_id;
+   std::memcpy(wal_entry->payload, o_key, o_key_length);
+   std::memcpy(wal_entry->payload + o_key_length, value, value_length);
+   wal_entry.submit();
+   // -------------------------------------------------------------------------------------
+   cr::Worker::my().logging.checkLogDepdency(old_head.worker_id, old_head.tx_ts);
+   // -------------------------------------------------------------------------------------
+   auto& tuple_head = *new (iterator.mutableValue().data()) ChainedTuple(cr::Worker::my().workerID(), cr::activeTX().startTS());
+   tuple_head.command_id = command_id;
+   std::memcpy(tuple_head.payload, value, value_length);
+   // -------------------------------------------------------------------------------------
+   iterator.markAsDirty();
+   invalidateColdReplica(key);
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::insertSorted(const std::vector<std::pair<Slice, Slice>>& kvs)
+{
+   cr::activeTX().markAsWrite();
+   u64 kv_i = 0;
+   while (kv_i < kvs.size()) {
+      cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 2);
+      jumpmuTry()
+      {
+         // One round per leaf: the keys that stay within its fences are inserted under the same latch and logged together
+         BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+         const u64 run_begin = kv_i;
+         u64 wal_length = 0;
+         OP_RESULT ret = OP_RESULT::OK;
+         bool split = false;
+         while (kv_i < kvs.size()) {
+            const auto& [key, value] = kvs[kv_i];
+            if (kv_i > run_begin && (!iterator.keyInCurrentBoundaries(key) || wal_length + insertBatchEntryLength(key, value) > PAGE_SIZE)) {
+               break;
+            }
+            ret = iterator.seekToInsert(key);
+            if (ret == OP_RESULT::DUPLICATE) {
+               const auto& primary_version = *reinterpret_cast<const ChainedTuple*>(iterator.value().data());
+               if (primary_version.isWriteLocked() || !isVisibleForMe(primary_version.worker_id, primary_version.tx_ts, true)) {
+                  ret = OP_RESULT::ABORT_TX;
+               }
+               break;
+            }
+            const u16 payload_length = value.length() + sizeof(ChainedTuple);
+            if (iterator.enoughSpaceInCurrentNode(key, payload_length) == OP_RESULT::NOT_ENOUGH_SPACE) {
+               // Log the run first, the next round splits
+               split = (kv_i == run_begin);
+               break;
+            }
+            iterator.insertInCurrentNode(key, payload_length);
+            auto& primary_version = *new (iterator.mutableValue().data()) ChainedTuple(cr::Worker::my().workerID(), cr::activeTX().startTS());
+            std::memcpy(primary_version.payload, value.data(), value.length());
+            if (cr::activeTX().current_tx_mode == TX_MODE::INSTANTLY_VISIBLE_BULK_INSERT) {
+               primary_version.tx_ts = MSB | 0;
+            }
+            invalidateColdReplica(key);
+            wal_length += insertBatchEntryLength(key, value);
+            kv_i++;
          }
-         // -------------------------------------------------------------------------------------
-         iterator.markAsDirty();
+         if (kv_i > run_begin) {
+            logInsertBatch(iterator, kvs, run_begin, kv_i, wal_length);
+            iterator.markAsDirty();
+         }
+         if (split) {
+            iterator.splitForKey(kvs[kv_i].first);
+         }
+         if (ret != OP_RESULT::OK) {
+            jumpmu_return ret;
+         }
+      }
+      jumpmuCatch()
+      {
+         UNREACHABLE();
+      }
+   }
+   return OP_RESULT::OK;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::upsert(u8* o_key, u16 o_key_length, u8* value, u16 value_length)
+{
+   cr::activeTX().markAsWrite();
+   cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   Slice key(o_key, o_key_length);
+   const u16 payload_length = value_length + sizeof(ChainedTuple);
+   // -------------------------------------------------------------------------------------
+   while (true) {
+      jumpmuTry()
+      {
+         BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+         OP_RESULT ret = iterator.seekToInsert(key);
+         if (ret == OP_RESULT::DUPLICATE) {
+            const auto& tuple = *reinterpret_cast<const Tuple*>(iterator.value().data());
+            if (tuple.tuple_format == TupleFormat::CHAINED && reinterpret_cast<const ChainedTuple&>(tuple).is_removed) {
+               // Removed but not garbage collected yet: insert over it
+               if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
+                  jumpmu_return OP_RESULT::ABORT_TX;
+               }
+               if (reinsertAt(iterator, o_key, o_key_length, value, value_length) == OP_RESULT::NOT_ENOUGH_SPACE) {
+                  iterator.splitForKey(key);
+                  jumpmu_continue;
+               }
+               jumpmu_return OP_RESULT::OK;
+            }
+            if (tuple.tuple_format == TupleFormat::FAT_TUPLE_DIFFERENT_ATTRIBUTES &&
+                reinterpret_cast<const FatTupleDifferentAttributes&>(tuple).value_length == value_length) {
+               // Keep the fat tuple when the length does not change, replace the whole value as a single attribute
+               u8 descriptor_buffer[sizeof(UpdateSameSizeInPlaceDescriptor) + sizeof(UpdateSameSizeInPlaceDescriptor::Slot)];
+               auto& update_descriptor = *reinterpret_cast<UpdateSameSizeInPlaceDescriptor*>(descriptor_buffer);
+               update_descriptor.count = 1;
+               update_descriptor.slots[0] = {0, value_length};
+               jumpmu_return updateSameSizeInPlaceAt(
+                   iterator, o_key, o_key_length, [&](u8* current_value, u16) { std::memcpy(current_value, value, value_length); }, update_descriptor);
+            }
+            jumpmu_return updateVariableSizeAt(
+                iterator, o_key, o_key_length,
+                [&](u16, u16& new_value_length) {
+                   new_value_length = value_length;
+                   return true;
+                },
+                [&](const u8*, u16, u8* new_value, u16) { std::memcpy(new_value, value, value_length); });
+         }
+         ret = iterator.enoughSpaceInCurrentNode(key, payload_length);
+         if (ret == OP_RESULT::NOT_ENOUGH_SPACE) {
+            iterator.splitForKey(key);
+            jumpmu_continue;
+         }
+         insertAt(iterator, o_key, o_key_length, value, value_length);
+         jumpmu_return OP_RESULT::OK;
+      }
+      jumpmuCatch()
+      {
+         UNREACHABLE();
+      }
+   }
+   UNREACHABLE();
+   return OP_RESULT::OTHER;
+}
+// -------------------------------------------------------------------------------------
+OP_RESULT BTreeVI::merge(u8* o_key,
+                         u16 o_key_length,
+                         u8* operand,
+                         u16 operand_length,
+                         function<void(u8* value, u16 value_length)> merge_fn,
+                         UpdateSameSizeInPlaceDescriptor& update_descriptor)
+{
+   cr::activeTX().markAsWrite();
+   cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
+   Slice key(o_key, o_key_length);
+   const u16 payload_length = operand_length + sizeof(ChainedTuple);
+   // -------------------------------------------------------------------------------------
+   while (true) {
+      jumpmuTry()
+      {
+         BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(this));
+         OP_RESULT ret = iterator.seekToInsert(key);
+         if (ret == OP_RESULT::DUPLICATE) {
+            const auto& tuple = *reinterpret_cast<const Tuple*>(iterator.value().data());
+            if (tuple.tuple_format == TupleFormat::CHAINED && reinterpret_cast<const ChainedTuple&>(tuple).is_removed) {
+               // Removed but not garbage collected yet: the operand is inserted over it, as for an absent key
+               if (tuple.isWriteLocked() || !isVisibleForMe(tuple.worker_id, tuple.tx_ts, true)) {
+                  jumpmu_return OP_RESULT::ABORT_TX;
+               }
+               if (reinsertAt(iterator, o_key, o_key_length, operand, operand_length) == OP_RESULT::NOT_ENOUGH_SPACE) {
+                  iterator.splitForKey(key);
+                  jumpmu_continue;
+               }
+               jumpmu_return OP_RESULT::OK;
+            }
+            // The merge function runs on the latched head, no other transaction can slip in between read and write
+            jumpmu_return updateSameSizeInPlaceAt(iterator, o_key, o_key_length, merge_fn, update_descriptor);
+         }
+         ret = iterator.enoughSpaceInCurrentNode(key, payload_length);
+         if (ret == OP_RESULT::NOT_ENOUGH_SPACE) {
+            iterator.splitForKey(key);
+            jumpmu_continue;
+         }
+         insertAt(iterator, o_key, o_key_length, operand, operand_length);
          jumpmu_return OP_RESULT::OK;
       }
       jumpmuCatch()
@@ -473,6 +982,7 @@ OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
       if (FLAGS_vi_fremove) {
          ret = iterator.removeCurrent();
          ensure(ret == OP_RESULT::OK);
+         invalidateColdReplica(key);
          iterator.mergeIfNeeded();
          jumpmu_return OP_RESULT::OK;
       }
@@ -495,7 +1005,7 @@ OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
       dangling_pointer.bf = iterator.leaf.bf;
       dangling_pointer.latch_version_should_be = iterator.leaf.guard.version;
       dangling_pointer.head_slot = iterator.cur;
-      const u16 value_length = iterator.value().length() - sizeof(ChainedTuple);
+      const u16 value_length = chain_head.valueLength(iterator.value().length());
       const u16 version_payload_length = sizeof(RemoveVersion) + value_length + o_key_length;
       const COMMANDID command_id = cr::Worker::my().cc.insertVersion(dt_id, true, version_payload_length, [&](u8* secondary_payload) {
          auto& secondary_version =
@@ -524,6 +1034,7 @@ OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
       if (payload.length() - sizeof(ChainedTuple) > 1) {
          iterator.shorten(sizeof(ChainedTuple));
       }
+      chain_head.has_inline_versions = false;
       chain_head.is_removed = true;
       chain_head.worker_id = cr::Worker::my().workerID();
       chain_head.tx_ts = cr::activeTX().startTS();
@@ -531,6 +1042,7 @@ OP_RESULT BTreeVI::remove(u8* o_key, u16 o_key_length)
       // -------------------------------------------------------------------------------------
       chain_head.unlock();
       iterator.markAsDirty();
+      invalidateColdReplica(key);
       // -------------------------------------------------------------------------------------
       jumpmu_return OP_RESULT::OK;
    }
@@ -563,6 +1075,31 @@ void BTreeVI::undo(void* btree_object, const u8* wal_entry_ptr, const u64)
          jumpmuCatch() {}
          break;
       }
+      case WAL_LOG_TYPE::WALInsertBatch: {
+         auto& batch_entry = *reinterpret_cast<const WALInsertBatch*>(&entry);
+         std::vector<Slice> keys;
+         const u8* wal_ptr = batch_entry.payload;
+         for (u16 i = 0; i < batch_entry.count; i++) {
+            u16 lengths[2];
+            std::memcpy(lengths, wal_ptr, sizeof(lengths));
+            keys.emplace_back(wal_ptr + sizeof(lengths), lengths[0]);
+            wal_ptr += sizeof(lengths) + lengths[0] + lengths[1];
+         }
+         for (auto key = keys.rbegin(); key != keys.rend(); key++) {
+            jumpmuTry()
+            {
+               BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(&btree));
+               OP_RESULT ret = iterator.seekExact(*key);
+               ensure(ret == OP_RESULT::OK);
+               ret = iterator.removeCurrent();
+               ensure(ret == OP_RESULT::OK);
+               iterator.markAsDirty();  // TODO: write CLS
+               iterator.mergeIfNeeded();
+            }
+            jumpmuCatch() {}
+         }
+         break;
+      }
       case WAL_LOG_TYPE::WALUpdate: {
          auto& update_entry = *reinterpret_cast<const WALUpdateSSIP*>(&entry);
          jumpmuTry()
@@ -597,6 +1134,64 @@ void BTreeVI::undo(void* btree_object, const u8* wal_entry_ptr, const u64)
          }
          break;
       }
+      case WAL_LOG_TYPE::WALSplice: {
+         auto& splice_entry = *reinterpret_cast<const WALSplice*>(&entry);
+         Slice key(splice_entry.payload, splice_entry.key_length);
+         jumpmuTry()
+         {
+            BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(&btree));
+            OP_RESULT ret = iterator.seekExact(key);
+            ensure(ret == OP_RESULT::OK);
+            // Put the before range back in place of the after range
+            const Slice current_payload = iterator.value();
+            u8 payload[current_payload.length()];
+            std::memcpy(payload, current_payload.data(), current_payload.length());
+            ensure(reinterpret_cast<const Tuple*>(payload)->tuple_format == TupleFormat::CHAINED);
+            const u16 tail_offset = sizeof(ChainedTuple) + splice_entry.offset + splice_entry.after_length;
+            const u16 tail_length = current_payload.length() - tail_offset;
+            const u16 old_payload_length = sizeof(ChainedTuple) + splice_entry.offset + splice_entry.before_length + tail_length;
+            if (old_payload_length > current_payload.length()) {
+               const bool did_extend = iterator.extendPayload(old_payload_length);
+               ensure(did_extend);
+            } else if (old_payload_length < current_payload.length()) {
+               iterator.shorten(old_payload_length);
+            }
+            u8* old_payload = iterator.mutableValue().data();
+            std::memcpy(old_payload, payload, sizeof(ChainedTuple) + splice_entry.offset);
+            std::memcpy(old_payload + sizeof(ChainedTuple) + splice_entry.offset, splice_entry.payload + splice_entry.key_length, splice_entry.before_length);
+            std::memcpy(old_payload + old_payload_length - tail_length, payload + tail_offset, tail_length);
+            auto& chain_head = *reinterpret_cast<ChainedTuple*>(old_payload);
+            chain_head.worker_id = splice_entry.before_worker_id;
+            chain_head.tx_ts = splice_entry.before_tx_id;
+            chain_head.command_id = splice_entry.before_command_id;
+            iterator.markAsDirty();
+         }
+         jumpmuCatch()
+         {
+            UNREACHABLE();
+         }
+         break;
+      }
+      case WAL_LOG_TYPE::WALReinsert: {
+         auto& reinsert_entry = *reinterpret_cast<const WALReinsert*>(&entry);
+         Slice key(reinsert_entry.payload, reinsert_entry.key_length);
+         jumpmuTry()
+         {
+            BTreeExclusiveIterator iterator(*static_cast<BTreeGeneric*>(&btree));
+            OP_RESULT ret = iterator.seekExact(key);
+            ensure(ret == OP_RESULT::OK);
+            iterator.shorten(sizeof(ChainedTuple));
+            auto& chain_head = *new (iterator.mutableValue().data()) ChainedTuple(reinsert_entry.before_worker_id, reinsert_entry.before_tx_id);
+            chain_head.command_id = reinsert_entry.before_command_id;
+            chain_head.is_removed = true;
+            iterator.markAsDirty();
+         }
+         jumpmuCatch()
+         {
+            UNREACHABLE();
+         }
+         break;
+      }
       case WAL_LOG_TYPE::WALRemove: {
          auto& remove_entry = *reinterpret_cast<const WALRemove*>(&entry);
          Slice key(remove_entry.payload, remove_entry.key_length);
@@ -805,11 +1400,21 @@ void BTreeVI::unlock(void* btree_object, const u8* wal_entry_ptr)
          key = Slice(update_entry.payload, update_entry.key_length);
          break;
       }
+      case WAL_LOG_TYPE::WALSplice: {
+         auto& splice_entry = *reinterpret_cast<const WALSplice*>(&entry);
+         key = Slice(splice_entry.payload, splice_entry.key_length);
+         break;
+      }
       case WAL_LOG_TYPE::WALRemove: {
          auto& remove_entry = *reinterpret_cast<const WALRemove*>(&entry);
          key = Slice(remove_entry.payload, remove_entry.key_length);
          break;
       }
+      case WAL_LOG_TYPE::WALReinsert: {
+         auto& reinsert_entry = *reinterpret_cast<const WALReinsert*>(&entry);
+         key = Slice(reinsert_entry.payload, reinsert_entry.key_length);
+         break;
+      }
       default: {
          return;
          break;
@@ -874,6 +1479,7 @@ OP_RESULT BTreeVI::scanAsc(u8* o_key,
 // TODO: Implement inserts after remove cases
 std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Slice key, Slice payload, std::function<void(Slice value)> callback)
 {
+   PROFILE_REGION(RegionCounters::VERSION_RECONSTRUCTION);
    u16 chain_length = 1;
    u16 materialized_value_length;
    std::unique_ptr<u8[]> materialized_value;
@@ -882,47 +1488,73 @@ std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Sli
       if (chain_head.is_removed) {
          return {OP_RESULT::NOT_FOUND, 1};
       } else {
-         callback(Slice(chain_head.payload, payload.length() - sizeof(ChainedTuple)));
+         callback(Slice(chain_head.payload, chain_head.valueLength(payload.length())));
          return {OP_RESULT::OK, 1};
       }
    }
    // -------------------------------------------------------------------------------------
    // Head is not visible
-   materialized_value_length = payload.length() - sizeof(ChainedTuple);
+   materialized_value_length = chain_head.valueLength(payload.length());
    materialized_value = std::make_unique<u8[]>(materialized_value_length);
    std::memcpy(materialized_value.get(), chain_head.payload, materialized_value_length);
    WORKERID next_worker_id = chain_head.worker_id;
    TXID next_tx_id = chain_head.tx_ts;
    COMMANDID next_command_id = chain_head.command_id;
+   bool materialized_removed = false;  // Reached the before-image of a reinsert
    // -------------------------------------------------------------------------------------
    while (true) {
-      bool found =
-          cr::Worker::my().cc.retrieveVersion(next_worker_id, next_tx_id, next_command_id, [&](const u8* version_payload, u64 version_length) {
-             const auto& version = *reinterpret_cast<const Version*>(version_payload);
-             if (version.type == Version::TYPE::UPDATE) {
-                const auto& update_version = *reinterpret_cast<const UpdateVersion*>(version_payload);
-                if (update_version.is_delta) {
-                   // Apply delta
-                   const auto& update_descriptor = *reinterpret_cast<const UpdateSameSizeInPlaceDescriptor*>(update_version.payload);
-                   BTreeLL::applyDiff(update_descriptor, materialized_value.get(), update_version.payload + update_descriptor.size());
-                } else {
-                   materialized_value_length = version_length - sizeof(UpdateVersion);
-                   materialized_value = std::make_unique<u8[]>(materialized_value_length);
-                   std::memcpy(materialized_value.get(), update_version.payload, materialized_value_length);
-                }
-             } else if (version.type == Version::TYPE::REMOVE) {
-                const auto& remove_version = *reinterpret_cast<const RemoveVersion*>(version_payload);
-                materialized_value_length = remove_version.value_length;
-                materialized_value = std::make_unique<u8[]>(materialized_value_length);
-                std::memcpy(materialized_value.get(), remove_version.payload, materialized_value_length);
-             } else {
-                UNREACHABLE();
-             }
-             // -------------------------------------------------------------------------------------
-             next_worker_id = version.worker_id;
-             next_tx_id = version.tx_id;
-             next_command_id = version.command_id;
-          });
+      if (next_command_id == ChainedTuple::BATCH_COMMANDID) {
+         // A deterministic batch updated the tuple after our snapshot without keeping the before-image
+         return {OP_RESULT::ABORT_TX, chain_length};
+      }
+      if (next_command_id == ChainedTuple::ELIDED_COMMANDID) {
+         // An update that we can not see yet elided the before-image, never answer from a wrong version.
+         // Retryable: the update is visible for the snapshots that start after its commit
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().cc_read_chains_elided[dt_id]++; }
+         return {OP_RESULT::ABORT_TX, chain_length};
+      }
+      auto apply_version = [&](const u8* version_payload, u64 version_length) {
+         const auto& version = *reinterpret_cast<const Version*>(version_payload);
+         if (version.type == Version::TYPE::UPDATE) {
+            const auto& update_version = *reinterpret_cast<const UpdateVersion*>(version_payload);
+            materialized_removed = update_version.is_removed;
+            if (update_version.is_removed) {
+               // Nothing to materialize, the tuple did not exist before
+            } else if (update_version.is_delta) {
+               // Apply delta
+               const auto& update_descriptor = *reinterpret_cast<const UpdateSameSizeInPlaceDescriptor*>(update_version.payload);
+               BTreeLL::applyDiff(update_descriptor, materialized_value.get(), update_version.payload + update_descriptor.size());
+            } else {
+               materialized_value_length = version_length - sizeof(UpdateVersion);
+               materialized_value = std::make_unique<u8[]>(materialized_value_length);
+               std::memcpy(materialized_value.get(), update_version.payload, materialized_value_length);
+            }
+         } else if (version.type == Version::TYPE::REMOVE) {
+            const auto& remove_version = *reinterpret_cast<const RemoveVersion*>(version_payload);
+            materialized_removed = false;
+            materialized_value_length = remove_version.value_length;
+            materialized_value = std::make_unique<u8[]>(materialized_value_length);
+            std::memcpy(materialized_value.get(), remove_version.payload + remove_version.key_length, materialized_value_length);
+         } else {
+            UNREACHABLE();
+         }
+         // -------------------------------------------------------------------------------------
+         next_worker_id = version.worker_id;
+         next_tx_id = version.tx_id;
+         next_command_id = version.command_id;
+      };
+      u16 inline_version_length;
+      bool found;
+      if (const u8* inline_version = findInlineVersion(payload, next_worker_id, next_tx_id, next_command_id, inline_version_length)) {
+         apply_version(inline_version, inline_version_length);
+         found = true;
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().cc_read_versions_inline[dt_id]++;
+         }
+      } else {
+         found = cr::Worker::my().cc.retrieveVersion(next_worker_id, next_tx_id, next_command_id, apply_version);
+      }
       if (!found) {
          cerr << std::find(cr::Worker::my().cc.local_workers_start_ts.get(),
                            cr::Worker::my().cc.local_workers_start_ts.get() + cr::Worker::my().workers_count, next_tx_id) -
@@ -934,6 +1566,9 @@ std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Sli
          return {OP_RESULT::NOT_FOUND, chain_length};
       }
       if (isVisibleForMe(next_worker_id, next_tx_id, false)) {
+         if (materialized_removed) {
+            return {OP_RESULT::NOT_FOUND, chain_length};
+         }
          callback(Slice(materialized_value.get(), materialized_value_length));
          return {OP_RESULT::OK, chain_length};
       }
@@ -943,6 +1578,111 @@ std::tuple<OP_RESULT, u16> BTreeVI::reconstructChainedTuple([[maybe_unused]] Sli
    return {OP_RESULT::NOT_FOUND, chain_length};
 }
 // -------------------------------------------------------------------------------------
+// Cuts the tree into segments of consecutive cold tuples, a tuple that is not cold or a valid segment ends the current one
+u64 BTreeVI::refreshColdReplica()
+{
+   if (!cold_replica) {
+      return 0;
+   }
+   cold_replica->removeDropped();
+   u64 segments_counter = 0;
+   std::basic_string<u8> next_key;
+   bool end_reached = false;
+   while (!end_reached) {
+      ColdReplica::SegmentBuilder builder(cold_replica->columns);
+      std::vector<std::pair<WORKERID, TXID>> heads;
+      end_reached = true;
+      BTreeLL::scanAsc(
+          const_cast<u8*>(next_key.data()), next_key.length(),
+          [&](const u8* key, u16 key_length, const u8* payload, u16 payload_length) {
+             const Slice s_key(key, key_length);
+             const auto& tuple = *reinterpret_cast<const ChainedTuple*>(payload);
+             const bool is_cold = isColdChainedTuple(tuple);
+             if (is_cold && tuple.is_removed) {
+                return true;  // Gone for everybody
+             }
+             if (auto covering = cold_replica->find(s_key)) {
+                next_key = covering->upper;
+                next_key.push_back(0);
+                end_reached = false;
+                return false;
+             }
+             if (is_cold && builder.add(s_key, Slice(tuple.payload, tuple.valueLength(payload_length)))) {
+                heads.emplace_back(tuple.worker_id, tuple.tx_ts);
+                if (builder.rowCount() == cold_replica->segment_rows) {
+                   next_key = std::basic_string<u8>(s_key);
+                   next_key.push_back(0);
+                   end_reached = false;
+                   return false;
+                }
+                return true;
+             }
+             if (builder.rowCount() == 0) {
+                return true;
+             }
+             // Start over from this tuple after sealing what we have
+             next_key = std::basic_string<u8>(s_key);
+             end_reached = false;
+             return false;
+          },
+          []() {});
+      if (builder.rowCount() == 0) {
+         continue;
+      }
+      // -------------------------------------------------------------------------------------
+      auto segment = builder.seal();
+      cold_replica->publish(segment);
+      if (validateColdSegment(*segment, heads) && cold_replica->activate(*segment)) {
+         segments_counter++;
+      } else {
+         cold_replica->drop(*segment);
+      }
+   }
+   return segments_counter;
+}
+// -------------------------------------------------------------------------------------
+// Called after publishing the segment: from here on, writers into its range drop it themselves
+bool BTreeVI::validateColdSegment(const ColdReplica::Segment& segment, const std::vector<std::pair<WORKERID, TXID>>& heads)
+{
+   // Removed tuples that OLAP may still see live in the graveyard, scanOLAP skips the graveyard over the range of a segment
+   bool graveyard_empty = graveyard->isRangeSurelyEmpty(Slice(segment.lower), Slice(segment.upper));
+   if (!graveyard_empty) {
+      graveyard_empty = true;
+      graveyard->scanAsc(
+          const_cast<u8*>(segment.lower.data()), segment.lower.length(),
+          [&](const u8* key, u16 key_length, const u8*, u16) {
+             graveyard_empty = Slice(key, key_length) > Slice(segment.upper);
+             return false;
+          },
+          []() {});
+   }
+   if (!graveyard_empty) {
+      return false;
+   }
+   // -------------------------------------------------------------------------------------
+   u32 row_i = 0;
+   bool unchanged = true;
+   BTreeLL::scanAsc(
+       const_cast<u8*>(segment.lower.data()), segment.lower.length(),
+       [&](const u8* key, u16 key_length, const u8* payload, u16) {
+          const Slice s_key(key, key_length);
+          if (s_key > Slice(segment.upper)) {
+             return false;
+          }
+          const auto& tuple = *reinterpret_cast<const ChainedTuple*>(payload);
+          const bool is_cold = isColdChainedTuple(tuple);
+          if (is_cold && tuple.is_removed) {
+             return true;
+          }
+          unchanged = is_cold && row_i < segment.row_count && s_key == segment.key(row_i) && tuple.worker_id == heads[row_i].first &&
+                      tuple.tx_ts == heads[row_i].second;
+          row_i++;
+          return unchanged;
+       },
+       []() {});
+   return unchanged && row_i == segment.row_count;
+}
+// -------------------------------------------------------------------------------------
 }  // namespace btree
 }  // namespace storage
 }  // namespace leanstore
@@ -1,6 +1,7 @@
 // BTreeVI and BTreeVW are work in progress!
 #pragma once
 #include "BTreeLL.hpp"
+#include "ColdReplica.hpp"
 #include "core/BTreeGenericIterator.hpp"
 #include "leanstore/Config.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
@@ -53,6 +54,16 @@ class BTreeVI : public BTreeLL
       TXID before_command_id;
       u8 payload[];
    };
+   struct WALSplice : WALEntry {
+      u16 key_length;
+      u16 offset;
+      u16 before_length;
+      u16 after_length;
+      WORKERID before_worker_id;
+      TXID before_tx_id;
+      COMMANDID before_command_id;
+      u8 payload[];  // key | before | after
+   };
    struct WALRemove : WALEntry {
       u16 key_length;
       u16 value_length;
@@ -61,6 +72,15 @@ class BTreeVI : public BTreeLL
       u64 before_command_id;
       u8 payload[];
    };
+   // Insert over a removed tuple that is not garbage collected yet, undo puts the removed head back
+   struct WALReinsert : WALEntry {
+      u16 key_length;
+      u16 value_length;
+      WORKERID before_worker_id;
+      TXID before_tx_id;
+      COMMANDID before_command_id;
+      u8 payload[];  // key | value
+   };
    // -------------------------------------------------------------------------------------
    /*
      Plan: we should handle frequently and infrequently updated tuples differently when it comes to maintaining
@@ -86,6 +106,8 @@ class BTreeVI : public BTreeLL
    // NEVER SHADOW A MEMBER!!!
    struct __attribute__((packed)) Tuple {
       static constexpr COMMANDID INVALID_COMMANDID = std::numeric_limits<COMMANDID>::max();
+      static constexpr COMMANDID ELIDED_COMMANDID = INVALID_COMMANDID - 1;  // Chain ends, but the before-image was not kept
+      static constexpr COMMANDID BATCH_COMMANDID = INVALID_COMMANDID - 2;   // Same, written by a deterministic batch
       TupleFormat tuple_format;
       WORKERID worker_id;
       union {
@@ -110,13 +132,33 @@ class BTreeVI : public BTreeLL
       u16 updates_counter = 0;
       u16 oldest_tx = 0;
       u8 is_removed : 1;
+      u8 has_inline_versions : 1;  // The payload ends with InlineVersions and their total length (u16), costs nothing when off
       // -------------------------------------------------------------------------------------
       u8 payload[];  // latest version in-place
                      // -------------------------------------------------------------------------------------
-      ChainedTuple(WORKERID worker_id, TXID tx_id) : Tuple(TupleFormat::CHAINED, worker_id, tx_id), is_removed(false) { reset(); }
+      ChainedTuple(WORKERID worker_id, TXID tx_id) : Tuple(TupleFormat::CHAINED, worker_id, tx_id), is_removed(false), has_inline_versions(false)
+      {
+         reset();
+      }
       bool isFinal() const { return command_id == INVALID_COMMANDID; }
+      // Bytes behind the value: the InlineVersions and the length itself
+      u16 inlineLength(u64 payload_length) const
+      {
+         return has_inline_versions ? *reinterpret_cast<const u16*>(reinterpret_cast<const u8*>(this) + payload_length - sizeof(u16)) : 0;
+      }
+      u16 valueLength(u64 payload_length) const { return payload_length - sizeof(ChainedTuple) - inlineLength(payload_length); }
       void reset() {}
    };
+   // Copy of a recent UpdateVersion from the history tree, newest first behind the value of the chained tuple (FLAGS_vi_inline_versions),
+   // the last one is followed by the u16 length of the whole area (ChainedTuple::has_inline_versions)
+   // Readers of slightly stale snapshots find it without a history lookup, the history tree stays the authority for undo and GC
+   struct __attribute__((packed)) InlineVersion {
+      WORKERID worker_id;  // As referenced by the newer version
+      TXID tx_ts;
+      COMMANDID command_id;
+      u16 version_length;
+      u8 version[];  // UpdateVersion
+   };
    // -------------------------------------------------------------------------------------
    // We always append the descriptor, one format to keep simple
    struct __attribute__((packed)) FatTupleDifferentAttributes : Tuple {
@@ -191,10 +233,11 @@ class BTreeVI : public BTreeLL
    };
    struct __attribute__((packed)) UpdateVersion : Version {
       u8 is_delta : 1;
-      u8 payload[];  // UpdateDescriptor + Diff
+      u8 is_removed : 1;  // Before-image of a reinsert: the tuple did not exist, no payload
+      u8 payload[];       // UpdateDescriptor + Diff
       // -------------------------------------------------------------------------------------
-      UpdateVersion(WORKERID worker_id, TXID tx_id, COMMANDID command_id, bool is_delta)
-          : Version(Version::TYPE::UPDATE, worker_id, tx_id, command_id), is_delta(is_delta)
+      UpdateVersion(WORKERID worker_id, TXID tx_id, COMMANDID command_id, bool is_delta, bool is_removed = false)
+          : Version(Version::TYPE::UPDATE, worker_id, tx_id, command_id), is_delta(is_delta), is_removed(is_removed)
       {
       }
       bool isFinal() const { return command_id == 0; }
@@ -216,6 +259,21 @@ class BTreeVI : public BTreeLL
    OP_RESULT insert(u8* key, u16 key_length, u8* value, u16 value_length) override;
    OP_RESULT updateSameSizeInPlace(u8* key, u16 key_length, function<void(u8* value, u16 value_size)>, UpdateSameSizeInPlaceDescriptor&) override;
    OP_RESULT remove(u8* key, u16 key_length) override;
+   // The before-image goes to the version chain as a whole, the WAL gets the changed range only
+   using KVInterface::updateVariableSize;
+   OP_RESULT updateVariableSize(u8* key,
+                                u16 key_length,
+                                function<bool(u16 value_length, u16& new_value_length)>,
+                                function<void(const u8* value, u16 value_length, u8* new_value, u16 new_value_length)>) override;
+   // Runs of keys within the fences of one leaf share the latch and a WALInsertBatch
+   OP_RESULT insertSorted(const std::vector<std::pair<Slice, Slice>>& kvs) override;
+   OP_RESULT upsert(u8* key, u16 key_length, u8* value, u16 value_length) override;
+   OP_RESULT merge(u8* key,
+                   u16 key_length,
+                   u8* operand,
+                   u16 operand_length,
+                   function<void(u8* value, u16 value_length)> merge_fn,
+                   UpdateSameSizeInPlaceDescriptor&) override;
    OP_RESULT scanAsc(u8* start_key,
                      u16 key_length,
                      function<bool(const u8* key, u16 key_length, const u8* value, u16 value_length)>,
@@ -231,6 +289,9 @@ class BTreeVI : public BTreeLL
                                          BTreeExclusiveIterator& iterator,
                                          function<void(u8* value, u16 value_size)>,
                                          UpdateSameSizeInPlaceDescriptor&);
+   // Update of a cr::DeterministicBatch: the batch logs its input and its plan leaves no conflict to abort on, so the chained
+   // case neither creates a version nor writes WAL
+   OP_RESULT updateDeterministic(u8* key, u16 key_length, function<void(u8* value, u16 value_size)>, UpdateSameSizeInPlaceDescriptor&);
 
    // -------------------------------------------------------------------------------------
    void create(DTID dtid, Config config, BTreeLL* graveyard_btree)
@@ -261,10 +322,48 @@ class BTreeVI : public BTreeLL
 
   public:
    BTreeLL* graveyard;
+   // -------------------------------------------------------------------------------------
+   // Columnar replica of the cold ranges, scanOLAP reads them from there instead of reconstructing tuple by tuple
+   // Enable before the workers start, refresh from a background thread (LeanStore::startColdReplicaThread)
+   std::unique_ptr<ColdReplica> cold_replica;
+   void enableColdReplica(std::vector<ColdReplica::Column> columns)
+   {
+      cold_replica = std::make_unique<ColdReplica>(std::move(columns), FLAGS_vi_cold_replica_segment_rows);
+   }
+   u64 refreshColdReplica();  // Returns the number of segments built
 
   private:
    // -------------------------------------------------------------------------------------
+   // Write paths on an iterator that is already positioned on the key (insertAt: on its insert position with enough space)
+   OP_RESULT updateSameSizeInPlaceAt(BTreeExclusiveIterator& iterator,
+                                     u8* key,
+                                     u16 key_length,
+                                     function<void(u8* value, u16 value_size)>,
+                                     UpdateSameSizeInPlaceDescriptor&);
+   OP_RESULT updateVariableSizeAt(BTreeExclusiveIterator& iterator,
+                                  u8* key,
+                                  u16 key_length,
+                                  function<bool(u16 value_length, u16& new_value_length)>,
+                                  function<void(const u8* value, u16 value_length, u8* new_value, u16 new_value_length)>);
+   void insertAt(BTreeExclusiveIterator& iterator, u8* key, u16 key_length, u8* value, u16 value_length);
+   // On a removed tuple that is visible for me and not write locked, NOT_ENOUGH_SPACE when the value does not fit the leaf
+   OP_RESULT reinsertAt(BTreeExclusiveIterator& iterator, u8* key, u16 key_length, u8* value, u16 value_length);
    bool convertChainedToFatTupleDifferentAttributes(BTreeExclusiveIterator& iterator);
+   // After every change of a tuple and before the transaction can commit
+   inline void invalidateColdReplica(Slice key)
+   {
+      if (cold_replica) {
+         cold_replica->invalidate(key);
+      }
+   }
+   bool isColdChainedTuple(const ChainedTuple& tuple) const
+   {
+      return tuple.tuple_format == TupleFormat::CHAINED && !tuple.isWriteLocked() && cr::Worker::my().cc.isVisibleForAll(tuple.worker_id, tuple.tx_ts);
+   }
+   // Prepends version (nullptr: none) to the inline versions of the chained tuple of the iterator, keep_older = false drops the others
+   void refreshInlineVersions(BTreeExclusiveIterator& iterator, const u8* version, u16 version_length, bool keep_older);
+   static const u8* findInlineVersion(Slice payload, WORKERID worker_id, TXID tx_ts, COMMANDID command_id, u16& version_length);
+   bool validateColdSegment(const ColdReplica::Segment& segment, const std::vector<std::pair<WORKERID, TXID>>& heads);
    // -------------------------------------------------------------------------------------
    OP_RESULT lookupPessimistic(u8* key, const u16 key_length, function<void(const u8*, u16)> payload_callback);
    OP_RESULT lookupOptimistic(const u8* key, const u16 key_length, function<void(const u8*, u16)> payload_callback);
@@ -318,6 +417,9 @@ class BTreeVI : public BTreeLL
             if (!keep_scanning) {
                jumpmu_return OP_RESULT::OK;
             }
+            if (std::get<0>(reconstruct) == OP_RESULT::ABORT_TX) {
+               jumpmu_return OP_RESULT::ABORT_TX;
+            }
             // -------------------------------------------------------------------------------------
             if constexpr (asc) {
                ret = iterator.next();
@@ -372,12 +474,52 @@ class BTreeVI : public BTreeLL
             }
          };
          g_range();
+         bool aborted = false;  // Hit an update that elided its before-image
+         u8 materialized[PAGE_SIZE];
+         std::basic_string<u8> resume_key;
+         // Serve the rest of a valid cold segment at once, then continue with the first key after it in both trees
+         auto take_from_cold_replica = [&](const ColdReplica::Segment& segment) {
+            for (u32 row_i = segment.lowerBound(iterator.key()); row_i < segment.row_count; row_i++) {
+               segment.materialize(row_i, materialized);
+               const Slice s_key = segment.key(row_i);
+               COUNTERS_BLOCK()
+               {
+                  WorkerCounters::myCounters().dt_scan_callback[dt_id] += cr::activeTX().isOLAP();
+                  WorkerCounters::myCounters().dt_cold_replica_rows[dt_id]++;
+               }
+               keep_scanning = callback(s_key.data(), s_key.length(), materialized, segment.payload_length);
+               if (!keep_scanning) {
+                  return false;
+               }
+            }
+            resume_key = segment.upper;
+            resume_key.push_back(0);
+            g_iterator.reset();
+            o_ret = iterator.seek(Slice(resume_key));
+            g_lower_bound = Slice(resume_key);
+            if (o_ret == OP_RESULT::OK) {
+               iterator.assembleKey();
+               g_upper_bound = Slice(iterator.leaf->getUpperFenceKey(), iterator.leaf->upper_fence.length);
+               g_range();
+            } else {
+               g_ret = g_iterator.seek(g_lower_bound);
+            }
+            return true;
+         };
          auto take_from_oltp = [&]() {
-            reconstructTuple(iterator.key(), iterator.value(), [&](Slice value) {
+            if (cold_replica) {
+               // A writer that drops the segment from now on commits after our snapshot, so its rows are still what we have to see
+               auto segment = cold_replica->find(iterator.key());
+               if (segment) {
+                  return take_from_cold_replica(*segment);
+               }
+            }
+            const auto reconstruct = reconstructTuple(iterator.key(), iterator.value(), [&](Slice value) {
                COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_scan_callback[dt_id] += cr::activeTX().isOLAP(); }
                keep_scanning = callback(iterator.key().data(), iterator.key().length(), value.data(), value.length());
             });
-            if (!keep_scanning) {
+            aborted = (std::get<0>(reconstruct) == OP_RESULT::ABORT_TX);
+            if (!keep_scanning || aborted) {
                return false;
             }
             const bool is_last_one = iterator.isLastOne();
@@ -396,7 +538,7 @@ class BTreeVI : public BTreeLL
             if (g_ret != OP_RESULT::OK && o_ret == OP_RESULT::OK) {
                iterator.assembleKey();
                if (!take_from_oltp()) {
-                  jumpmu_return OP_RESULT::OK;
+                  jumpmu_return(aborted ? OP_RESULT::ABORT_TX : OP_RESULT::OK);
                }
             } else if (g_ret == OP_RESULT::OK && o_ret != OP_RESULT::OK) {
                g_iterator.assembleKey();
@@ -416,7 +558,7 @@ class BTreeVI : public BTreeLL
                Slice oltp_key = iterator.key();
                if (oltp_key <= g_key) {
                   if (!take_from_oltp()) {
-                     jumpmu_return OP_RESULT::OK;
+                     jumpmu_return(aborted ? OP_RESULT::ABORT_TX : OP_RESULT::OK);
                   }
                } else {
                   reconstructTuple(g_key, g_iterator.value(), [&](Slice value) {
@@ -456,7 +598,7 @@ class BTreeVI : public BTreeLL
                   if (primary_version.is_removed) {
                      jumpmu_return{OP_RESULT::NOT_FOUND, 1};
                   }
-                  callback(Slice(primary_version.payload, payload.length()));
+                  callback(Slice(primary_version.payload, primary_version.valueLength(payload.length())));
                   jumpmu_return{OP_RESULT::OK, 1};
                } else {
                   if (primary_version.isFinal()) {
@@ -0,0 +1,292 @@
+#include "ColdReplica.hpp"
+
+#include "Exceptions.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+namespace
+{
+u64 loadInteger(const u8* src, u8 length)
+{
+   u64 value = 0;
+   std::memcpy(&value, src, length);
+   return value;
+}
+}  // namespace
+// -------------------------------------------------------------------------------------
+u64 ColdReplica::ColumnChunk::minInteger() const
+{
+   return loadInteger(min.data(), length);
+}
+// -------------------------------------------------------------------------------------
+u64 ColdReplica::ColumnChunk::maxInteger() const
+{
+   return loadInteger(max.data(), length);
+}
+// -------------------------------------------------------------------------------------
+u64 ColdReplica::ColumnChunk::integer(u32 row_i) const
+{
+   assert(isInteger());
+   if (width == 0) {
+      return minInteger();
+   }
+   return minInteger() + loadInteger(values.get() + u64(row_i) * width, width);
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::ColumnChunk::copy(u32 row_i, u8* dst) const
+{
+   if (width == 0) {
+      std::memcpy(dst, min.data(), length);
+   } else if (isInteger()) {
+      const u64 value = integer(row_i);
+      std::memcpy(dst, &value, length);
+   } else {
+      std::memcpy(dst, values.get() + u64(row_i) * length, length);
+   }
+}
+// -------------------------------------------------------------------------------------
+u32 ColdReplica::Segment::lowerBound(Slice key) const
+{
+   u32 lower = 0, upper = row_count;
+   while (lower < upper) {
+      const u32 mid = lower + (upper - lower) / 2;
+      if (this->key(mid) < key) {
+         lower = mid + 1;
+      } else {
+         upper = mid;
+      }
+   }
+   return lower;
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::Segment::materialize(u32 row_i, u8* payload) const
+{
+   assert(row_i < row_count);
+   for (const ColumnChunk& column : columns) {
+      column.copy(row_i, payload + column.offset);
+   }
+}
+// -------------------------------------------------------------------------------------
+bool ColdReplica::SegmentBuilder::add(Slice key, Slice payload)
+{
+   if (rowCount() == 0) {
+      payload_length = payload.length();
+      for (const Column& column : columns) {
+         if (column.offset + column.length > payload_length) {
+            return false;
+         }
+      }
+   } else if (payload.length() != payload_length) {
+      return false;
+   }
+   keys.append(key);
+   key_offsets.push_back(keys.length());
+   payloads.append(payload);
+   return true;
+}
+// -------------------------------------------------------------------------------------
+std::shared_ptr<ColdReplica::Segment> ColdReplica::SegmentBuilder::seal()
+{
+   ensure(rowCount() > 0);
+   auto segment = std::make_shared<Segment>();
+   segment->row_count = rowCount();
+   segment->payload_length = payload_length;
+   segment->keys = std::move(keys);
+   segment->key_offsets = std::move(key_offsets);
+   segment->lower = std::basic_string<u8>(segment->key(0));
+   segment->upper = std::basic_string<u8>(segment->key(segment->row_count - 1));
+   // -------------------------------------------------------------------------------------
+   // Bytes of the payload that no column covers are kept in implicit columns, so materialize() restores the whole payload
+   std::vector<Column> layout;
+   {
+      std::vector<bool> covered(payload_length, false);
+      for (const Column& column : columns) {
+         layout.push_back(column);
+         std::fill(covered.begin() + column.offset, covered.begin() + column.offset + column.length, true);
+      }
+      for (u16 offset = 0; offset < payload_length; offset++) {
+         if (!covered[offset]) {
+            u16 length = 1;
+            while (offset + length < payload_length && !covered[offset + length]) {
+               length++;
+            }
+            layout.push_back({offset, length});
+            offset += length - 1;
+         }
+      }
+   }
+   // -------------------------------------------------------------------------------------
+   const u32 row_count = segment->row_count;
+   auto value = [&](u32 row_i, const Column& column) { return payloads.data() + u64(row_i) * payload_length + column.offset; };
+   for (const Column& column : layout) {
+      ColumnChunk chunk;
+      chunk.offset = column.offset;
+      chunk.length = column.length;
+      if (chunk.isInteger()) {
+         u64 min = std::numeric_limits<u64>::max(), max = 0;
+         for (u32 row_i = 0; row_i < row_count; row_i++) {
+            const u64 v = loadInteger(value(row_i, column), column.length);
+            min = std::min(min, v);
+            max = std::max(max, v);
+         }
+         chunk.min = std::basic_string<u8>(reinterpret_cast<u8*>(&min), column.length);
+         chunk.max = std::basic_string<u8>(reinterpret_cast<u8*>(&max), column.length);
+         const u64 range = max - min;
+         chunk.width = (range == 0) ? 0 : (range <= 0xFF) ? 1 : (range <= 0xFFFF) ? 2 : (range <= 0xFFFFFFFF) ? 4 : 8;
+         if (chunk.width) {
+            chunk.values = std::make_unique<u8[]>(u64(row_count) * chunk.width);
+            for (u32 row_i = 0; row_i < row_count; row_i++) {
+               const u64 delta = loadInteger(value(row_i, column), column.length) - min;
+               std::memcpy(chunk.values.get() + u64(row_i) * chunk.width, &delta, chunk.width);
+            }
+         }
+      } else {
+         const u8 *min = value(0, column), *max = min;
+         bool constant = true;
+         for (u32 row_i = 1; row_i < row_count; row_i++) {
+            const u8* v = value(row_i, column);
+            const int cmp_min = std::memcmp(v, min, column.length);
+            constant &= (cmp_min == 0);
+            if (cmp_min < 0) {
+               min = v;
+            } else if (std::memcmp(v, max, column.length) > 0) {
+               max = v;
+            }
+         }
+         chunk.min = std::basic_string<u8>(min, column.length);
+         chunk.max = std::basic_string<u8>(max, column.length);
+         chunk.width = constant ? 0 : 1;
+         if (!constant) {
+            chunk.values = std::make_unique<u8[]>(u64(row_count) * column.length);
+            for (u32 row_i = 0; row_i < row_count; row_i++) {
+               std::memcpy(chunk.values.get() + u64(row_i) * column.length, value(row_i, column), column.length);
+            }
+         }
+      }
+      segment->columns.push_back(std::move(chunk));
+   }
+   return segment;
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::invalidate(Slice key)
+{
+   if (isEmpty()) {
+      return;
+   }
+   std::shared_lock guard(mutex);
+   auto it = segments.upper_bound(std::basic_string<u8>(key));
+   if (it == segments.begin()) {
+      return;
+   }
+   --it;
+   Segment& segment = *it->second;
+   if (Slice(segment.upper) >= key) {
+      // BUILDING too: the builder then fails to activate it
+      segment.state.store(STATE::DROPPED, std::memory_order_release);
+   }
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::publish(std::shared_ptr<Segment> segment)
+{
+   std::unique_lock guard(mutex);
+   // Keep the segments disjoint, so the segment with the greatest lower key <= key is the only candidate to cover key
+   auto it = segments.upper_bound(segment->lower);
+   if (it != segments.begin()) {
+      --it;
+   }
+   while (it != segments.end() && Slice(it->first) <= Slice(segment->upper)) {
+      if (Slice(it->second->upper) >= Slice(segment->lower)) {
+         ensure(it->second->state.load() == STATE::DROPPED);
+         it = segments.erase(it);
+         segments_counter--;
+      } else {
+         ++it;
+      }
+   }
+   segments.emplace(segment->lower, std::move(segment));
+   segments_counter++;
+}
+// -------------------------------------------------------------------------------------
+bool ColdReplica::activate(Segment& segment)
+{
+   STATE expected = STATE::BUILDING;
+   return segment.state.compare_exchange_strong(expected, STATE::VALID, std::memory_order_acq_rel);
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::drop(Segment& segment)
+{
+   segment.state.store(STATE::DROPPED, std::memory_order_release);
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::removeDropped()
+{
+   std::unique_lock guard(mutex);
+   for (auto it = segments.begin(); it != segments.end();) {
+      if (it->second->state.load() == STATE::DROPPED) {
+         it = segments.erase(it);
+         segments_counter--;
+      } else {
+         ++it;
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+std::shared_ptr<ColdReplica::Segment> ColdReplica::find(Slice key) const
+{
+   if (isEmpty()) {
+      return nullptr;
+   }
+   std::shared_lock guard(mutex);
+   auto it = segments.upper_bound(std::basic_string<u8>(key));
+   if (it == segments.begin()) {
+      return nullptr;
+   }
+   --it;
+   if (it->second->isValid() && Slice(it->second->upper) >= key) {
+      return it->second;
+   }
+   return nullptr;
+}
+// -------------------------------------------------------------------------------------
+void ColdReplica::forEachSegment(Slice lower, Slice upper, std::function<bool(const Segment&)> callback) const
+{
+   std::vector<std::shared_ptr<Segment>> overlapping;
+   {
+      std::shared_lock guard(mutex);
+      auto it = segments.upper_bound(std::basic_string<u8>(lower));
+      if (it != segments.begin()) {
+         --it;
+      }
+      for (; it != segments.end() && Slice(it->first) <= upper; ++it) {
+         if (Slice(it->second->upper) >= lower && it->second->isValid()) {
+            overlapping.push_back(it->second);
+         }
+      }
+   }
+   for (auto& segment : overlapping) {
+      // A concurrent writer may drop a segment at any time, callers that need a stable view must recheck isValid() afterwards
+      if (segment->isValid() && !callback(*segment)) {
+         return;
+      }
+   }
+}
+// -------------------------------------------------------------------------------------
+u64 ColdReplica::countSegments() const
+{
+   std::shared_lock guard(mutex);
+   return std::count_if(segments.begin(), segments.end(), [](auto& it) { return it.second->isValid(); });
+}
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
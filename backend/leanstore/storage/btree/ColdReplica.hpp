@@ -0,0 +1,110 @@
+#pragma once
+#include "Units.hpp"
+#include "leanstore/KVInterface.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace btree
+{
+// -------------------------------------------------------------------------------------
+// Read-optimized copy of the cold key ranges of a BTreeVI for OLAP scans
+// Every row of a segment is visible for all and not removed, so the segment answers for any snapshot without version reconstruction
+// Segments are PAX: the payload is split into fixed columns, each column of a segment is stored contiguously with its min/max
+// Any write into the key range of a segment drops it, the scan then falls back to the B-tree for that range
+class ColdReplica
+{
+  public:
+   struct Column {
+      u16 offset;  // in the payload
+      u16 length;
+   };
+   // Minipage of one column in one segment
+   // Integer columns (length 1, 2, 4 or 8) are frame-of-reference encoded: values - min in the narrowest width that fits max - min
+   // A constant column stores nothing but min
+   struct ColumnChunk {
+      u16 offset, length;
+      u8 width;  // Bytes per stored value of integer columns, 0 for constant columns, other columns store length bytes per value
+      std::basic_string<u8> min, max;
+      std::unique_ptr<u8[]> values;
+      // -------------------------------------------------------------------------------------
+      bool isInteger() const { return length == 1 || length == 2 || length == 4 || length == 8; }
+      u64 minInteger() const;
+      u64 maxInteger() const;
+      u64 integer(u32 row_i) const;  // Pre: isInteger()
+      void copy(u32 row_i, u8* dst) const;
+   };
+   enum class STATE : u8 { BUILDING, VALID, DROPPED };
+   struct Segment {
+      std::basic_string<u8> lower, upper;  // Inclusive key range
+      u32 row_count = 0;
+      u16 payload_length = 0;
+      std::vector<u32> key_offsets;  // row_count + 1 offsets into keys
+      std::basic_string<u8> keys;
+      std::vector<ColumnChunk> columns;
+      std::atomic<STATE> state = STATE::BUILDING;
+      // -------------------------------------------------------------------------------------
+      bool isValid() const { return state.load(std::memory_order_acquire) == STATE::VALID; }
+      Slice key(u32 row_i) const { return Slice(keys.data() + key_offsets[row_i], key_offsets[row_i + 1] - key_offsets[row_i]); }
+      u32 lowerBound(Slice key) const;  // First row with a key >= key
+      void materialize(u32 row_i, u8* payload) const;
+   };
+   // Collects the rows of one segment in key order, then encodes them
+   class SegmentBuilder
+   {
+     private:
+      const std::vector<Column>& columns;
+      std::basic_string<u8> keys, payloads;
+      std::vector<u32> key_offsets = {0};
+      u16 payload_length = 0;
+
+     public:
+      SegmentBuilder(const std::vector<Column>& columns) : columns(columns) {}
+      u32 rowCount() const { return key_offsets.size() - 1; }
+      // Returns false when the payload does not match the layout of the segment
+      bool add(Slice key, Slice payload);
+      std::shared_ptr<Segment> seal();
+   };
+   // -------------------------------------------------------------------------------------
+   const std::vector<Column> columns;
+   const u32 segment_rows;
+
+  private:
+   std::map<std::basic_string<u8>, std::shared_ptr<Segment>> segments;  // by lower key
+   mutable std::shared_mutex mutex;
+   std::atomic<u64> segments_counter = 0;
+
+  public:
+   ColdReplica(std::vector<Column> columns, u32 segment_rows) : columns(std::move(columns)), segment_rows(segment_rows) {}
+   // -------------------------------------------------------------------------------------
+   // Writers: called after changing the tuple of key and before the transaction can commit
+   void invalidate(Slice key);
+   bool isEmpty() const { return segments_counter.load(std::memory_order_acquire) == 0; }
+   // -------------------------------------------------------------------------------------
+   // Builder (one thread per replica): publish as BUILDING, re-validate the rows against the tree, then activate
+   // Activation fails when a write hit the range in between
+   void publish(std::shared_ptr<Segment> segment);
+   bool activate(Segment& segment);
+   void drop(Segment& segment);
+   void removeDropped();
+   // -------------------------------------------------------------------------------------
+   // Readers
+   std::shared_ptr<Segment> find(Slice key) const;  // Valid segment that covers key, if any
+   // Valid segments that overlap [lower, upper] in key order, for column-wise processing and min/max pruning
+   void forEachSegment(Slice lower, Slice upper, std::function<bool(const Segment&)> callback) const;
+   u64 countSegments() const;
+};
+// -------------------------------------------------------------------------------------
+}  // namespace btree
+}  // namespace storage
+}  // namespace leanstore
@@ -79,8 +79,8 @@ void BTreeVI::FatTupleDifferentAttributes::garbageCollection()
       }
    }
    // -------------------------------------------------------------------------------------
-   const TXID local_oldest_oltp = cr::Worker::my().global_oldest_oltp_start_ts.load();
-   const TXID local_newest_olap = cr::Worker::my().global_newest_olap_start_ts.load();
+   const TXID local_oldest_oltp = cr::Worker::my().global.oldest_oltp_start_ts.load();
+   const TXID local_newest_olap = cr::Worker::my().global.newest_olap_start_ts.load();
    if (deltas_visible_by_all_counter == 0 && local_newest_olap > local_oldest_oltp) {
       return;  // Nothing to do here
    }
@@ -308,6 +308,7 @@ std::tuple<OP_RESULT, u16> BTreeVI::FatTupleDifferentAttributes::reconstructTupl
       cb(Slice(getValueConstant(), value_length));
       return {OP_RESULT::OK, 1};
    } else if (deltas_count > 0) {
+      PROFILE_REGION(RegionCounters::VERSION_RECONSTRUCTION);
       u8 materialized_value[value_length];
       std::memcpy(materialized_value, getValueConstant(), value_length);
       // we have to apply the diffs
@@ -374,7 +375,7 @@ bool BTreeVI::convertChainedToFatTupleDifferentAttributes(BTreeExclusiveIterator
    auto& chain_head = *reinterpret_cast<ChainedTuple*>(head.data());
    ensure(chain_head.isWriteLocked());
    // -------------------------------------------------------------------------------------
-   fat_tuple->value_length = head.length() - sizeof(ChainedTuple);
+   fat_tuple->value_length = chain_head.valueLength(head.length());
    std::memcpy(fat_tuple->payload + fat_tuple->used_space, chain_head.payload, fat_tuple->value_length);
    fat_tuple->used_space += fat_tuple->value_length;
    fat_tuple->worker_id = chain_head.worker_id;
@@ -390,12 +391,21 @@ bool BTreeVI::convertChainedToFatTupleDifferentAttributes(BTreeExclusiveIterator
       if (cr::Worker::my().cc.isVisibleForAll(next_worker_id, next_tx_id)) {  // Pruning versions space might get delayed
          break;
       }
+      if (next_command_id == Tuple::BATCH_COMMANDID || next_command_id == Tuple::ELIDED_COMMANDID) {
+         // The chain ends without a before-image, only chained tuples make the readers that reach it abort
+         abort_conversion = true;
+         break;
+      }
       // -------------------------------------------------------------------------------------
       if (!cr::Worker::my().cc.retrieveVersion(next_worker_id, next_tx_id, next_command_id, [&](const u8* version, [[maybe_unused]] u64 payload_length) {
              number_of_deltas_to_replace++;
              const auto& chain_delta = *reinterpret_cast<const UpdateVersion*>(version);
              ensure(chain_delta.type == Version::TYPE::UPDATE);
-             ensure(chain_delta.is_delta);
+             if (!chain_delta.is_delta) {
+                // Before-image of a variable-size update, fat tuples keep one value length
+                abort_conversion = true;
+                return;
+             }
              const auto& update_descriptor = *reinterpret_cast<const UpdateSameSizeInPlaceDescriptor*>(chain_delta.payload);
              const u32 descriptor_and_diff_length = update_descriptor.size() + update_descriptor.diffLength();
              const u32 needed_space = sizeof(FatTupleDifferentAttributes::Delta) + descriptor_and_diff_length;
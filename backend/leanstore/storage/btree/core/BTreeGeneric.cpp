@@ -22,6 +22,7 @@ void BTreeGeneric::create(DTID dtid, Config config)
    Guard guard(meta_node_bf.asBufferFrame().header.latch, GUARD_STATE::EXCLUSIVE);
    meta_node_bf.asBufferFrame().header.keep_in_memory = true;
    meta_node_bf.asBufferFrame().page.dt_id = dtid;
+   BMC::global_bf->getDTRegistry().residentPageAdded(dtid);
    guard.unlock();
    // -------------------------------------------------------------------------------------
    auto root_write_guard_h = HybridPageGuard<BTreeNode>(dtid);
@@ -41,7 +42,7 @@ void BTreeGeneric::create(DTID dtid, Config config)
 void BTreeGeneric::trySplit(BufferFrame& to_split, s16 favored_split_pos)
 {
    cr::Worker::my().logging.walEnsureEnoughSpace(PAGE_SIZE * 1);
-   auto parent_handler = findParentEager(*this, to_split);
+   auto parent_handler = findParentWithPathHint(to_split);
    HybridPageGuard<BTreeNode> p_guard = parent_handler.getParentReadPageGuard<BTreeNode>();
    HybridPageGuard<BTreeNode> c_guard = HybridPageGuard(p_guard, parent_handler.swip.cast<BTreeNode>());
    if (c_guard->count <= 1)
@@ -213,10 +214,67 @@ struct ParentSwipHandler BTreeGeneric::findParentEager(BTreeGeneric& btree, Buff
    return findParent<false>(btree, to_find);
 }
 // -------------------------------------------------------------------------------------
+thread_local BTreeGeneric::PathHint BTreeGeneric::path_hint;
+// -------------------------------------------------------------------------------------
+struct ParentSwipHandler BTreeGeneric::findParentWithPathHint(BufferFrame& to_find)
+{
+   if (FLAGS_btree_path_hints && path_hint.btree == this) {
+      jumpmuTry()
+      {
+         // Bottom-up: splits mostly hit the leaves, their parents come next
+         for (s32 e_i = path_hint.length - 1; e_i >= 0; e_i--) {
+            PathHint::Entry& entry = path_hint.entries[e_i];
+            Guard p_guard(entry.parent_bf->header.latch, entry.parent_version);
+            const bool found = &entry.swip->asBufferFrameMasked() == &to_find;
+            p_guard.recheck();
+            if (found) {
+               ParentSwipHandler ret = {
+                   .swip = entry.swip->cast<BufferFrame>(), .parent_guard = std::move(p_guard), .parent_bf = entry.parent_bf, .pos = entry.pos};
+               COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_find_parent_path_hint[dt_id]++; }
+               jumpmu_return ret;
+            }
+         }
+      }
+      jumpmuCatch() {}
+   }
+   return findParentEager(*this, to_find);
+}
+// -------------------------------------------------------------------------------------
+void BTreeGeneric::prefetch(const u8* key, u16 key_length)
+{
+   if (!FLAGS_prefetch) {
+      return;
+   }
+   jumpmuTry()
+   {
+      HybridPageGuard<BTreeNode> p_guard(meta_node_bf);
+      Swip<BTreeNode>* c_swip = &p_guard->upper;
+      while (true) {
+         const bool evicted = c_swip->isEVICTED();
+         p_guard.recheck();
+         if (evicted) {
+            BMC::global_bf->prefetchSwip(*p_guard.bf, p_guard.guard.version, c_swip->cast<BufferFrame>());
+            COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_prefetch_requests[dt_id]++; }
+            break;
+         }
+         HybridPageGuard<BTreeNode> c_guard(p_guard, *c_swip);  // hot or cool, no IO
+         if (c_guard->is_leaf) {
+            break;
+         }
+         c_swip = &c_guard->lookupInner(key, key_length);
+         p_guard = std::move(c_guard);
+      }
+   }
+   jumpmuCatch()
+   {
+      // Best effort, the real access retries anyway
+   }
+}
+// -------------------------------------------------------------------------------------
 bool BTreeGeneric::tryMerge(BufferFrame& to_merge, bool swizzle_sibling)
 {
    // pos == p_guard->count means that the current node is the upper swip in parent
-   auto parent_handler = findParentEager(*this, to_merge);
+   auto parent_handler = findParentWithPathHint(to_merge);
    HybridPageGuard<BTreeNode> p_guard = parent_handler.getParentReadPageGuard<BTreeNode>();
    HybridPageGuard<BTreeNode> c_guard = HybridPageGuard(p_guard, parent_handler.swip.cast<BTreeNode>());
    int pos_in_parent = parent_handler.pos;
@@ -25,6 +25,9 @@ enum class WAL_LOG_TYPE : u8 {
    WALRemove = 3,
    WALAfterBeforeImage = 4,
    WALAfterImage = 5,
+   WALSplice = 6,
+   WALInsertBatch = 7,
+   WALReinsert = 8,
    WALLogicalSplit = 10,
    WALInitPage = 11
 };
@@ -56,6 +59,35 @@ class BTreeGeneric
    };
    Config config;
    // -------------------------------------------------------------------------------------
+   // Path hint: the last descent of this thread records the inner nodes it passed with the versions it saw, so that a split/merge
+   // right after it takes the parent from there instead of descending again. Only valid as long as the parent version is unchanged
+   struct PathHint {
+      static constexpr u16 max_length = 16;
+      struct Entry {
+         BufferFrame* parent_bf;
+         u64 parent_version;
+         Swip<BTreeNode>* swip;
+         s32 pos;  // count: upper, -2: root
+      };
+      BTreeGeneric* btree = nullptr;
+      u16 length = 0;
+      Entry entries[max_length];
+      // -------------------------------------------------------------------------------------
+      void reset(BTreeGeneric* new_btree)
+      {
+         btree = new_btree;
+         length = 0;
+      }
+      // Post: the child of p_guard has been latched, i.e., p_guard version was valid for swip
+      void add(HybridPageGuard<BTreeNode>& p_guard, Swip<BTreeNode>& swip, s32 pos)
+      {
+         if (length < max_length) {
+            entries[length++] = {p_guard.bf, p_guard.guard.version, &swip, pos};
+         }
+      }
+   };
+   static thread_local PathHint path_hint;
+   // -------------------------------------------------------------------------------------
    BTreeGeneric() = default;
    // -------------------------------------------------------------------------------------
    void create(DTID dtid, Config config);
@@ -81,26 +113,53 @@ class BTreeGeneric
    ~BTreeGeneric();
    // -------------------------------------------------------------------------------------
    // Helpers
+   // The pin outlives the level (root splits push it down), it is only dropped when the frame is reclaimed
+   inline void pinIfTopLevel(HybridPageGuard<BTreeNode>& guard, u16 level)
+   {
+      if (level < FLAGS_bm_pinned_levels && !guard.bf->header.keep_in_memory) {
+         guard.recheck();
+         guard.bf->header.keep_in_memory = true;
+      }
+   }
+   // A point access turns a scan-only leaf into a regular one
+   inline void unmarkScanOnly(HybridPageGuard<BTreeNode>& guard)
+   {
+      if (guard.bf->header.is_scan_only) {
+         guard.bf->header.is_scan_only = false;
+      }
+   }
    template <LATCH_FALLBACK_MODE mode = LATCH_FALLBACK_MODE::SHARED>
    inline void findLeafCanJump(HybridPageGuard<BTreeNode>& target_guard, const u8* key, const u16 key_length)
    {
+      PROFILE_REGION(RegionCounters::DESCENT);
       target_guard.unlock();
       HybridPageGuard<BTreeNode> p_guard(meta_node_bf);
       target_guard = HybridPageGuard<BTreeNode>(p_guard, p_guard->upper);
+      if (FLAGS_btree_path_hints) {
+         path_hint.reset(this);
+         path_hint.add(p_guard, p_guard->upper, -2);
+      }
       // -------------------------------------------------------------------------------------
       u16 volatile level = 0;
+      pinIfTopLevel(target_guard, level);
       // -------------------------------------------------------------------------------------
       while (!target_guard->is_leaf) {
          WorkerCounters::myCounters().dt_inner_page[dt_id]++;
-         Swip<BTreeNode>& c_swip = target_guard->lookupInner(key, key_length);
+         const s32 pos = target_guard->lowerBound<false>(key, key_length);
+         Swip<BTreeNode>& c_swip = (pos == target_guard->count) ? target_guard->upper : target_guard->getChild(pos);
          p_guard = std::move(target_guard);
          if (level == height - 1) {
             target_guard = HybridPageGuard(p_guard, c_swip, mode);
          } else {
             target_guard = HybridPageGuard(p_guard, c_swip);
          }
+         if (FLAGS_btree_path_hints) {
+            path_hint.add(p_guard, c_swip, pos);
+         }
          level = level + 1;
+         pinIfTopLevel(target_guard, level);
       }
+      unmarkScanOnly(target_guard);
       // -------------------------------------------------------------------------------------
       p_guard.unlock();
    }
@@ -123,8 +182,13 @@ class BTreeGeneric
       }
    }
    // -------------------------------------------------------------------------------------
+   // Optimistic descent that never reads synchronously: the first evicted swip on the path is handed to the prefetcher
+   void prefetch(const u8* key, u16 key_length);
+   // -------------------------------------------------------------------------------------
    static struct ParentSwipHandler findParentJump(BTreeGeneric& btree, BufferFrame& to_find);
    static struct ParentSwipHandler findParentEager(BTreeGeneric& btree, BufferFrame& to_find);
+   // Takes the parent from the path hint if the thread just passed it, findParentEager otherwise
+   struct ParentSwipHandler findParentWithPathHint(BufferFrame& to_find);
    // -------------------------------------------------------------------------------------
    // Note on Synchronization: findParent is called by the page provide thread which are not allowed to block
    // Therefore, we jump whenever we encounter a latched node on our way
@@ -139,7 +203,7 @@ class BTreeGeneric
          {
             Guard c_guard(to_find.header.latch);
             c_guard.toOptimisticOrJump();
-            BufferFrame::Header::OptimisticParentPointer optimistic_parent_pointer = to_find.header.optimistic_parent_pointer;
+            BufferFrame::OptimisticParentPointer optimistic_parent_pointer = BMC::global_bf->optimisticParentPointer(to_find);
             BufferFrame* parent_bf = optimistic_parent_pointer.parent_bf;
             c_guard.recheck();
             if (parent_bf != nullptr) {
@@ -233,9 +297,9 @@ class BTreeGeneric
             Guard c_guard(to_find.header.latch);
             c_guard.toOptimisticOrJump();
             c_guard.tryToExclusive();
-            to_find.header.optimistic_parent_pointer.update(parent_handler.parent_bf, parent_handler.parent_bf->header.pid,
-                                                            parent_handler.parent_bf->page.PLSN,
-                                                            reinterpret_cast<BufferFrame**>(&parent_handler.swip), parent_handler.pos);
+            BMC::global_bf->optimisticParentPointer(to_find).update(parent_handler.parent_bf, parent_handler.parent_bf->header.pid,
+                                                                    parent_handler.parent_bf->page.PLSN,
+                                                                    reinterpret_cast<BufferFrame**>(&parent_handler.swip), parent_handler.pos);
             c_guard.unlock();
             parent_handler.is_bf_updated = true;
          }
@@ -33,6 +33,7 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
    HybridPageGuard<BTreeNode> p_guard;  // Reset after every leaf change
    s32 leaf_pos_in_parent = -1;         // Reset after every leaf change
    bool shift_to_right_on_frozen_swips = true;
+   bool is_moving_to_sibling = false;  // next/prev crossing a leaf boundary, i.e., scanning
    // -------------------------------------------------------------------------------------
    u8 buffer[PAGE_SIZE];  // Used to copy key at cur and for upper_fence/lower_fence
    u16 fence_length = 0;
@@ -50,6 +51,10 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
             target_guard.unlock();
             p_guard = HybridPageGuard<BTreeNode>(btree.meta_node_bf);
             target_guard = HybridPageGuard<BTreeNode>(p_guard, p_guard->upper);
+            if (FLAGS_btree_path_hints) {
+               BTreeGeneric::path_hint.reset(&btree);
+               BTreeGeneric::path_hint.add(p_guard, p_guard->upper, -2);
+            }
             // -------------------------------------------------------------------------------------
             u16 volatile level = 0;
             // -------------------------------------------------------------------------------------
@@ -68,8 +73,14 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                } else {
                   target_guard = HybridPageGuard(p_guard, *c_swip);
                }
+               if (FLAGS_btree_path_hints) {
+                  BTreeGeneric::path_hint.add(p_guard, *c_swip, leaf_pos_in_parent);
+               }
                level = level + 1;
             }
+            if (!is_moving_to_sibling) {
+               btree.unmarkScanOnly(target_guard);
+            }
             // -------------------------------------------------------------------------------------
             p_guard.unlock();
             if (mode == LATCH_FALLBACK_MODE::EXCLUSIVE) {
@@ -110,6 +121,23 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
       }
    }
    // -------------------------------------------------------------------------------------
+   // Scan-resistant buffer management: the leaves swizzled in while moving from leaf to leaf are scan-only,
+   // they are released as soon as the scan moves on unless a point access touched them meanwhile.
+   // The release changes a swip of the parent, releasePage keeps p_guard valid for the optimistic sibling move
+   void leaveScanOnlyLeaf()
+   {
+      if (FLAGS_bm_scan_resistant && leaf.bf->header.is_scan_only) {
+         BMC::global_bf->releasePage(*leaf.bf, p_guard.bf ? &p_guard.guard : nullptr);
+      }
+      BufferManager::last_swizzled_bf = nullptr;
+   }
+   void markScanOnlyLeaf()
+   {
+      if (FLAGS_bm_scan_resistant && BufferManager::last_swizzled_bf == leaf.bf) {
+         leaf.bf->header.is_scan_only = true;
+      }
+   }
+   // -------------------------------------------------------------------------------------
   public:
    BTreePessimisticIterator(BTreeGeneric& btree, const LATCH_FALLBACK_MODE mode = LATCH_FALLBACK_MODE::SHARED) : btree(btree), mode(mode) {}
    // -------------------------------------------------------------------------------------
@@ -207,6 +235,7 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                cleanup_cb();
                cleanup_cb = nullptr;
             }
+            leaveScanOnlyLeaf();
             // -------------------------------------------------------------------------------------
             if (FLAGS_optimistic_scan && leaf_pos_in_parent != -1) {
                jumpmuTry()
@@ -222,6 +251,7 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                      }
                      leaf.recheck();
                      leaf = std::move(next_leaf);
+                     markScanOnlyLeaf();
                      leaf_pos_in_parent = next_leaf_pos;
                      cur = 0;
                      prefix_copied = false;
@@ -241,7 +271,10 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                jumpmuCatch() {}
             }
             // Construct the next key (lower bound)
+            is_moving_to_sibling = true;
             gotoPage(Slice(buffer, fence_length));
+            is_moving_to_sibling = false;
+            markScanOnlyLeaf();
             // -------------------------------------------------------------------------------------
             if (leaf->count == 0) {
                cleanUpCallback([&, to_find = leaf.bf]() {
@@ -288,6 +321,7 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                cleanup_cb();
                cleanup_cb = nullptr;
             }
+            leaveScanOnlyLeaf();
             // -------------------------------------------------------------------------------------
             if (FLAGS_optimistic_scan && leaf_pos_in_parent != -1) {
                jumpmuTry()
@@ -303,6 +337,7 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                      }
                      leaf.recheck();
                      leaf = std::move(next_leaf);
+                     markScanOnlyLeaf();
                      leaf_pos_in_parent = next_leaf_pos;
                      cur = leaf->count - 1;
                      prefix_copied = false;
@@ -321,7 +356,10 @@ class BTreePessimisticIterator : public BTreePessimisticIteratorInterface
                jumpmuCatch() {}
             }
             // Construct the next key (lower bound)
+            is_moving_to_sibling = true;
             gotoPage(Slice(buffer, fence_length));
+            is_moving_to_sibling = false;
+            markScanOnlyLeaf();
             // -------------------------------------------------------------------------------------
             if (leaf->count == 0) {
                COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_empty_leaf[btree.dt_id]++; }
@@ -1,9 +1,9 @@
 #pragma once
 #include "BufferFrame.hpp"
 #include "Units.hpp"
+#include "leanstore/storage/io/StorageDevice.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
-#include <libaio.h>
 #include <functional>
 #include <list>
 #include <unordered_map>
@@ -20,24 +20,21 @@ class AsyncWriteBuffer
       BufferFrame* bf;
       PID pid;
    };
-   io_context_t aio_context;
-   int fd;
+   std::unique_ptr<io::AsyncIO> aio;
    u64 page_size, batch_max_size;
    u64 pending_requests = 0;
 
   public:
    std::unique_ptr<BufferFrame::Page[]> write_buffer;
    std::unique_ptr<WriteCommand[]> write_buffer_commands;
-   std::unique_ptr<struct iocb[]> iocbs;
-   std::unique_ptr<struct iocb*[]> iocbs_ptr;
-   std::unique_ptr<struct io_event[]> events;
+   std::unique_ptr<io::IOEvent[]> events;
    // -------------------------------------------------------------------------------------
    // Debug
    // -------------------------------------------------------------------------------------
-   AsyncWriteBuffer(int fd, u64 page_size, u64 batch_max_size);
+   AsyncWriteBuffer(io::StorageDevice& device, u64 page_size, u64 batch_max_size);
    // Caller takes care of sync
    bool full();
-   void add(BufferFrame& bf, PID pid);
+   void add(BufferFrame& bf, PID pid, u64 offset);
    u64 submit();
    u64 pollEventsSync();
    void getWrittenBfs(std::function<void(BufferFrame&, u64, PID)> callback, u64 n_events);
@@ -15,17 +15,15 @@ namespace storage
 // -------------------------------------------------------------------------------------
 const u64 PAGE_SIZE = 4 * 1024;
 // -------------------------------------------------------------------------------------
+// The frame descriptor takes two cache lines: the latch and the hot fields. The page lives in a separate 4 KiB aligned array
+// (O_DIRECT), the optimistic parent pointers in a side array the buffer manager allocates on demand
 struct BufferFrame {
    enum class STATE : u8 { FREE = 0, HOT = 1, COOL = 2, LOADED = 3 };
    struct Header {
-      WORKERID last_writer_worker_id = std::numeric_limits<u8>::max();  // for RFA
-      LID last_written_plsn = 0;
-      STATE state = STATE::FREE;  // INIT:
-      std::atomic<bool> is_being_written_back = false;
-      bool keep_in_memory = false;
-      PID pid = 9999;         // INIT:
       HybridLatch latch = 0;  // INIT: // ATTENTION: NEVER DECREMENT
       // -------------------------------------------------------------------------------------
+      LID last_written_plsn = 0;
+      PID pid = 9999;  // INIT:
       BufferFrame* next_free_bf = nullptr;
       // -------------------------------------------------------------------------------------
       // Contention Split data structure
@@ -42,27 +40,31 @@ struct BufferFrame {
       };
       ContentionTracker contention_tracker;
       // -------------------------------------------------------------------------------------
-      struct OptimisticParentPointer {
-         BufferFrame* parent_bf = nullptr;
-         PID parent_pid;
-         LID parent_plsn = 0;
-         BufferFrame** swip_ptr = nullptr;
-         s64 pos_in_parent = -1;
-         void update(BufferFrame* new_parent_bf, PID new_parent_pid, LID new_parent_gsn, BufferFrame** new_swip_ptr, s64 new_pos_in_parent)
-         {
-            if (parent_bf != new_parent_bf || parent_pid != new_parent_pid || parent_plsn != new_parent_gsn || swip_ptr != new_swip_ptr ||
-                pos_in_parent != new_pos_in_parent) {
-               parent_bf = new_parent_bf;
-               parent_pid = new_parent_pid;
-               parent_plsn = new_parent_gsn;
-               swip_ptr = new_swip_ptr;
-               pos_in_parent = new_pos_in_parent;
-            }
+      u32 crc = 0;
+      WORKERID last_writer_worker_id = std::numeric_limits<u8>::max();  // for RFA
+      STATE state = STATE::FREE;                                        // INIT:
+      std::atomic<bool> is_being_written_back = false;
+      bool keep_in_memory = false;
+      bool is_reclaimed = false;  // freed by its data structure while being written back, the write completion frees the frame
+      std::atomic<bool> is_scan_only = false;  // swizzled in by a scan and not touched by a point access since
+   };
+   struct OptimisticParentPointer {
+      BufferFrame* parent_bf = nullptr;
+      PID parent_pid;
+      LID parent_plsn = 0;
+      BufferFrame** swip_ptr = nullptr;
+      s64 pos_in_parent = -1;
+      void update(BufferFrame* new_parent_bf, PID new_parent_pid, LID new_parent_gsn, BufferFrame** new_swip_ptr, s64 new_pos_in_parent)
+      {
+         if (parent_bf != new_parent_bf || parent_pid != new_parent_pid || parent_plsn != new_parent_gsn || swip_ptr != new_swip_ptr ||
+             pos_in_parent != new_pos_in_parent) {
+            parent_bf = new_parent_bf;
+            parent_pid = new_parent_pid;
+            parent_plsn = new_parent_gsn;
+            swip_ptr = new_swip_ptr;
+            pos_in_parent = new_pos_in_parent;
          }
-      };
-      OptimisticParentPointer optimistic_parent_pointer;
-      // -------------------------------------------------------------------------------------
-      u64 crc = 0;
+      }
    };
    struct alignas(512) Page {
       LID PLSN = 0;
@@ -75,9 +77,9 @@ struct BufferFrame {
       // -------------------------------------------------------------------------------------
    };
    // -------------------------------------------------------------------------------------
-   struct Header header;
+   [[no_unique_address]] Header header;  // lets page reuse the tail padding of the header
    // -------------------------------------------------------------------------------------
-   struct Page page;  // The persisted part
+   Page& page;  // The persisted part
    // -------------------------------------------------------------------------------------
    bool operator==(const BufferFrame& other) { return this == &other; }
    // -------------------------------------------------------------------------------------
@@ -99,17 +101,19 @@ struct BufferFrame {
       header.next_free_bf = nullptr;
       header.contention_tracker.reset();
       header.keep_in_memory = false;
+      header.is_reclaimed = false;
+      header.is_scan_only = false;
       // std::memset(reinterpret_cast<u8*>(&page), 0, PAGE_SIZE);
    }
    // -------------------------------------------------------------------------------------
-   BufferFrame() { header.latch->store(0ul); }
+   BufferFrame(Page& page) : page(page) { header.latch->store(0ul); }
 };
 // -------------------------------------------------------------------------------------
 static constexpr u64 EFFECTIVE_PAGE_SIZE = sizeof(BufferFrame::Page::dt);
 // -------------------------------------------------------------------------------------
 static_assert(sizeof(BufferFrame::Page) == PAGE_SIZE, "");
 // -------------------------------------------------------------------------------------
-static_assert((sizeof(BufferFrame) - sizeof(BufferFrame::Page)) == 512, "");
+static_assert(sizeof(BufferFrame) == 128, "");
 // -------------------------------------------------------------------------------------
 }  // namespace storage
 }  // namespace leanstore
@@ -4,6 +4,7 @@
 #include "BufferFrame.hpp"
 #include "Exceptions.hpp"
 #include "leanstore/Config.hpp"
+#include "leanstore/concurrency-recovery/CRMG.hpp"
 #include "leanstore/profiling/counters/CPUCounters.hpp"
 #include "leanstore/profiling/counters/PPCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
@@ -15,10 +16,15 @@
 #include <gflags/gflags.h>
 // -------------------------------------------------------------------------------------
 #include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
@@ -30,24 +36,30 @@ namespace storage
 {
 // -------------------------------------------------------------------------------------
 thread_local BufferFrame* BufferManager::last_read_bf = nullptr;
+thread_local BufferFrame* BufferManager::last_swizzled_bf = nullptr;
 // -------------------------------------------------------------------------------------
-BufferManager::BufferManager(s32 ssd_fd) : ssd_fd(ssd_fd)
+BufferManager::BufferManager(const std::vector<io::StorageDevice*>& ssd_devices)
 {
    // -------------------------------------------------------------------------------------
    // Init DRAM pool
    {
-      dram_pool_size = FLAGS_dram_gib * 1024 * 1024 * 1024 / sizeof(BufferFrame);
-      const u64 dram_total_size = sizeof(BufferFrame) * (dram_pool_size + safety_pages);
+      // The pages come first to keep them page aligned, the frame descriptors follow
+      dram_pool_size = FLAGS_dram_gib * 1024 * 1024 * 1024 / (sizeof(BufferFrame) + sizeof(BufferFrame::Page));
+      const u64 dram_total_size = (sizeof(BufferFrame) + sizeof(BufferFrame::Page)) * (dram_pool_size + safety_pages);
       void* big_memory_chunk = mmap(NULL, dram_total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
       if (big_memory_chunk == MAP_FAILED) {
          perror("Failed to allocate memory for the buffer pool");
          SetupFailed("Check the buffer pool size");
       } else {
-         bfs = reinterpret_cast<BufferFrame*>(big_memory_chunk);
+         pages = reinterpret_cast<BufferFrame::Page*>(big_memory_chunk);
+         bfs = reinterpret_cast<BufferFrame*>(pages + dram_pool_size + safety_pages);
       }
-      madvise(bfs, dram_total_size, MADV_HUGEPAGE);
-      madvise(bfs, dram_total_size,
+      madvise(big_memory_chunk, dram_total_size, MADV_HUGEPAGE);
+      madvise(big_memory_chunk, dram_total_size,
               MADV_DONTFORK);  // O_DIRECT does not work with forking.
+      if (FLAGS_optimistic_parent_pointer) {
+         optimistic_parent_pointers = std::make_unique<BufferFrame::OptimisticParentPointer[]>(dram_pool_size);
+      }
       // -------------------------------------------------------------------------------------
       // Initialize partitions
       partitions_count = (1 << FLAGS_partition_bits);
@@ -57,19 +69,32 @@ BufferManager::BufferManager(s32 ssd_fd) : ssd_fd(ssd_fd)
          partitions.push_back(std::make_unique<Partition>(p_i, partitions_count, free_bfs_limit));
       }
       // -------------------------------------------------------------------------------------
-      utils::Parallelize::parallelRange(dram_total_size, [&](u64 begin, u64 end) { memset(reinterpret_cast<u8*>(bfs) + begin, 0, end - begin); });
+      utils::Parallelize::parallelRange(dram_total_size, [&](u64 begin, u64 end) { memset(reinterpret_cast<u8*>(pages) + begin, 0, end - begin); });
       utils::Parallelize::parallelRange(dram_pool_size, [&](u64 bf_b, u64 bf_e) {
          u64 p_i = 0;
          for (u64 bf_i = bf_b; bf_i < bf_e; bf_i++) {
-            getPartition(p_i).dram_free_list.push(*new (bfs + bf_i) BufferFrame());
+            getPartition(p_i).dram_free_list.push(*new (bfs + bf_i) BufferFrame(pages[bf_i]));
             p_i = (p_i + 1) % partitions_count;
          }
       });
    }
+   // -------------------------------------------------------------------------------------
+   // Data devices
+   ssds_count = ssd_devices.size();
+   if (ssds_count == 0 || ssds_count > WorkerCounters::max_ssds || partitions_count % ssds_count != 0) {
+      SetupFailed("The number of SSDs has to divide the number of partitions");
+   }
+   for (io::StorageDevice* device : ssd_devices) {
+      auto ssd = std::make_unique<SSD>();
+      ssd->device = device;
+      ssds.push_back(std::move(ssd));
+   }
 }
 // -------------------------------------------------------------------------------------
 void BufferManager::startBackgroundThreads()
 {
+   // The threads serve the instance the calling thread is bound to
+   cr::CRManager* cr_manager = cr::CRManager::global;
    // Page Provider threads
    if (FLAGS_pp_threads) {  // make it optional for pure in-memory experiments
       std::vector<std::thread> pp_threads;
@@ -79,7 +104,9 @@ void BufferManager::startBackgroundThreads()
       // -------------------------------------------------------------------------------------
       for (u64 t_i = 0; t_i < FLAGS_pp_threads; t_i++) {
          pp_threads.emplace_back(
-             [&, t_i](u64 p_begin, u64 p_end) {
+             [&, t_i, cr_manager](u64 p_begin, u64 p_end) {
+                BMC::global_bf = this;
+                cr::CRManager::global = cr_manager;
                 if (FLAGS_pin_threads) {
                    utils::pinThisThread(FLAGS_worker_threads + FLAGS_wal + t_i);
                 } else {
@@ -100,6 +127,29 @@ void BufferManager::startBackgroundThreads()
          thread.detach();
       }
    }
+   // -------------------------------------------------------------------------------------
+   if (FLAGS_prefetch) {
+      std::thread prefetch_thread([&, cr_manager]() {
+         BMC::global_bf = this;
+         cr::CRManager::global = cr_manager;
+         CPUCounters::registerThread("prefetcher");
+         prefetchThread();
+      });
+      bg_threads_counter++;
+      prefetch_thread.detach();
+   }
+   // -------------------------------------------------------------------------------------
+   if (FLAGS_bm_dirty_target_pct > 0) {
+      ensure(!FLAGS_out_of_place);  // the cleaner writes in place
+      std::thread page_cleaner_thread([&, cr_manager]() {
+         BMC::global_bf = this;
+         cr::CRManager::global = cr_manager;
+         CPUCounters::registerThread("page_cleaner");
+         pageCleanerThread();
+      });
+      bg_threads_counter++;
+      page_cleaner_thread.detach();
+   }
 }
 // -------------------------------------------------------------------------------------
 std::unordered_map<std::string, std::string> BufferManager::serialize()
@@ -111,6 +161,8 @@ std::unordered_map<std::string, std::string> BufferManager::serialize()
       max_pid = std::max<PID>(getPartition(p_i).next_pid, max_pid);
    }
    map["max_pid"] = std::to_string(max_pid);
+   state_generation = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+   map["state_generation"] = std::to_string(state_generation);
    return map;
 }
 // -------------------------------------------------------------------------------------
@@ -121,6 +173,242 @@ void BufferManager::deserialize(std::unordered_map<std::string, std::string> map
    for (u64 p_i = 0; p_i < partitions_count; p_i++) {
       getPartition(p_i).next_pid = max_pid + p_i;
    }
+   state_generation = map.count("state_generation") ? std::stoull(map["state_generation"]) : 0;
+}
+// -------------------------------------------------------------------------------------
+void BufferManager::recordHotPages(const std::string& path)
+{
+   // Racy scan without latching: a stale PID is harmless because warmUp only follows the swips of the trees
+   std::vector<PID> hot_pids;
+   for (u64 bf_i = 0; bf_i < dram_pool_size; bf_i++) {
+      auto& bf = bfs[bf_i];
+      if (bf.header.state == BufferFrame::STATE::HOT) {
+         hot_pids.push_back(bf.header.pid);
+      }
+   }
+   const std::string tmp_path = path + ".tmp";
+   std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+   file.write(reinterpret_cast<const char*>(hot_pids.data()), hot_pids.size() * sizeof(PID));
+   file.close();
+   posix_check(rename(tmp_path.c_str(), path.c_str()) == 0);
+}
+// -------------------------------------------------------------------------------------
+u64 BufferManager::warmUp(const std::string& path)
+{
+   std::ifstream file(path, std::ios::binary | std::ios::ate);
+   if (!file.is_open()) {
+      return 0;
+   }
+   std::vector<PID> hot_pids(file.tellg() / sizeof(PID));
+   file.seekg(0);
+   file.read(reinterpret_cast<char*>(hot_pids.data()), hot_pids.size() * sizeof(PID));
+   std::sort(hot_pids.begin(), hot_pids.end());
+   // -------------------------------------------------------------------------------------
+   // Keep the free frames the page provider would otherwise start cooling for
+   u64 budget = 0;
+   for (u64 p_i = 0; p_i < partitions_count; p_i++) {
+      Partition& partition = getPartition(p_i);
+      budget += (partition.dram_free_list.counter > partition.free_bfs_limit) ? partition.dram_free_list.counter - partition.free_bfs_limit : 0;
+   }
+   u64 free_p_i = 0;
+   auto pop_free_bf = [&]() -> BufferFrame& {
+      while (getPartition(free_p_i).dram_free_list.counter <= getPartition(free_p_i).free_bfs_limit) {
+         free_p_i = (free_p_i + 1) % partitions_count;
+      }
+      BufferFrame& bf = getPartition(free_p_i).dram_free_list.tryPop();
+      free_p_i = (free_p_i + 1) % partitions_count;
+      return bf;
+   };
+   // -------------------------------------------------------------------------------------
+   // Level by level starting from the resident meta nodes, so every parent is swizzled before its children are considered
+   struct Load {
+      Swip<BufferFrame>* swip;
+      PID pid;
+      BufferFrame* bf;
+   };
+   std::vector<BufferFrame*> frontier;
+   for (u64 bf_i = 0; bf_i < dram_pool_size; bf_i++) {
+      if (!bfs[bf_i].isFree()) {
+         frontier.push_back(&bfs[bf_i]);
+      }
+   }
+   u64 loaded_pages = 0;
+   while (!frontier.empty() && budget > 0) {
+      std::vector<Load> loads;
+      for (BufferFrame* parent_bf : frontier) {
+         getDTRegistry().iterateChildrenSwips(parent_bf->page.dt_id, *parent_bf, [&](Swip<BufferFrame>& swip) {
+            if (swip.isEVICTED() && std::binary_search(hot_pids.begin(), hot_pids.end(), swip.asPageID()) && loads.size() < budget) {
+               loads.push_back({&swip, swip.asPageID(), nullptr});
+            }
+            return true;
+         });
+      }
+      std::sort(loads.begin(), loads.end(), [&](const Load& a, const Load& b) { return ssdOrder(a.pid, b.pid); });
+      for (auto& load : loads) {
+         load.bf = &pop_free_bf();
+      }
+      budget -= loads.size();
+      // -------------------------------------------------------------------------------------
+      // Runs of consecutive pages on one device are read with one readv each, the runs are spread over all hardware threads
+      constexpr u64 max_run_length = 256;
+      std::vector<std::pair<u64, u64>> runs;  // [begin, end) in loads
+      for (u64 l_i = 0; l_i < loads.size();) {
+         u64 l_e = l_i + 1;
+         while (l_e < loads.size() && l_e - l_i < max_run_length && loads[l_e].pid == loads[l_e - 1].pid + ssds_count) {
+            l_e++;
+         }
+         runs.push_back({l_i, l_e});
+         l_i = l_e;
+      }
+      std::atomic<u64> next_run = 0;
+      std::vector<std::thread> threads;
+      const u64 threads_count = std::min<u64>(runs.size(), std::thread::hardware_concurrency());
+      for (u64 t_i = 0; t_i < threads_count; t_i++) {
+         threads.emplace_back([&]() {
+            struct iovec iov[max_run_length];
+            for (u64 r_i = next_run++; r_i < runs.size(); r_i = next_run++) {
+               const auto [l_b, l_e] = runs[r_i];
+               for (u64 l_i = l_b; l_i < l_e; l_i++) {
+                  iov[l_i - l_b] = {.iov_base = loads[l_i].bf->page, .iov_len = PAGE_SIZE};
+               }
+               const s64 bytes_read = getSSD(loads[l_b].pid).device->readv(iov, l_e - l_b, getSSDOffset(loads[l_b].pid));
+               if (bytes_read != s64((l_e - l_b) * PAGE_SIZE)) {
+                  for (u64 l_i = l_b; l_i < l_e; l_i++) {
+                     readPageSync(loads[l_i].pid, loads[l_i].bf->page);
+                  }
+               }
+            }
+         });
+      }
+      for (auto& thread : threads) {
+         thread.join();
+      }
+      // -------------------------------------------------------------------------------------
+      frontier.clear();
+      for (auto& load : loads) {
+         BufferFrame& bf = *load.bf;
+         paranoid(bf.page.magic_debugging_number == load.pid);
+         bf.header.last_written_plsn = bf.page.PLSN;
+         bf.header.pid = load.pid;
+         if (FLAGS_crc_check) {
+            bf.header.crc = utils::CRC(bf.page.dt, EFFECTIVE_PAGE_SIZE);
+         }
+         getDTRegistry().residentPageAdded(bf.page.dt_id);
+         load.swip->warm(&bf);
+         bf.header.state = BufferFrame::STATE::HOT;
+         frontier.push_back(&bf);
+      }
+      loaded_pages += loads.size();
+      COUNTERS_BLOCK()
+      {
+         WorkerCounters::myCounters().read_operations_counter += runs.size();
+         for (const auto& run : runs) {
+            WorkerCounters::myCounters().ssd_reads[getSSDID(loads[run.first].pid)]++;
+         }
+      }
+   }
+   return loaded_pages;
+}
+// -------------------------------------------------------------------------------------
+void BufferManager::recordFreePages(const std::string& path)
+{
+   std::vector<PID> freed_pids, trimmed_pids;
+   for (u64 p_i = 0; p_i < partitions_count; p_i++) {
+      Partition& partition = getPartition(p_i);
+      std::unique_lock<std::mutex> g_guard(partition.pids_mutex);
+      freed_pids.insert(freed_pids.end(), partition.freed_pids.begin(), partition.freed_pids.end());
+      trimmed_pids.insert(trimmed_pids.end(), partition.trimmed_pids.begin(), partition.trimmed_pids.end());
+   }
+   // Layout: state generation | freed count | freed PIDs | trimmed PIDs
+   const u64 freed_count = freed_pids.size();
+   const std::string tmp_path = path + ".tmp";
+   std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+   file.write(reinterpret_cast<const char*>(&state_generation), sizeof(u64));
+   file.write(reinterpret_cast<const char*>(&freed_count), sizeof(u64));
+   file.write(reinterpret_cast<const char*>(freed_pids.data()), freed_pids.size() * sizeof(PID));
+   file.write(reinterpret_cast<const char*>(trimmed_pids.data()), trimmed_pids.size() * sizeof(PID));
+   file.close();
+   posix_check(rename(tmp_path.c_str(), path.c_str()) == 0);
+}
+// -------------------------------------------------------------------------------------
+u64 BufferManager::loadFreePages(const std::string& path)
+{
+   std::ifstream file(path, std::ios::binary | std::ios::ate);
+   if (!file) {
+      return 0;
+   }
+   const u64 file_size = file.tellg();
+   if (file_size < 2 * sizeof(u64)) {
+      return 0;
+   }
+   file.seekg(0);
+   u64 generation = 0, freed_count = 0;
+   file.read(reinterpret_cast<char*>(&generation), sizeof(u64));
+   if (generation != state_generation) {
+      // Leaking the freed pages of a stale map is safe, reusing them is not
+      cout << "Ignoring " << path << ", it does not belong to the recovered state" << endl;
+      return 0;
+   }
+   file.read(reinterpret_cast<char*>(&freed_count), sizeof(u64));
+   std::vector<PID> pids((file_size - 2 * sizeof(u64)) / sizeof(PID));
+   file.read(reinterpret_cast<char*>(pids.data()), pids.size() * sizeof(PID));
+   ensure(freed_count <= pids.size());
+   for (u64 p_i = 0; p_i < pids.size(); p_i++) {
+      Partition& partition = getPartition(pids[p_i]);
+      if (p_i < freed_count) {
+         partition.freePage(pids[p_i]);
+      } else {
+         partition.trimmedPage(pids[p_i]);
+      }
+   }
+   return pids.size();
+}
+// -------------------------------------------------------------------------------------
+// Hands the space of the oldest freed pages back to the SSDs: the batches of all partitions in [p_begin, p_end) are sorted to coalesce
+// consecutive pages of a device into one range. Files get their holes punched, block devices are discarded
+void BufferManager::trimFreedPages(u64 p_begin, u64 p_end)
+{
+   std::vector<PID> pids;
+   for (u64 p_i = p_begin; p_i < p_end; p_i++) {
+      getPartition(p_i).takePagesToTrim(pids, FLAGS_ssd_trim_batch);
+   }
+   if (pids.empty()) {
+      return;
+   }
+   std::sort(pids.begin(), pids.end(), [&](PID a, PID b) { return ssdOrder(a, b); });
+   for (u64 r_b = 0; r_b < pids.size();) {
+      u64 r_e = r_b + 1;
+      while (r_e < pids.size() && pids[r_e] == pids[r_e - 1] + ssds_count) {
+         r_e++;
+      }
+      getSSD(pids[r_b]).device->discard(getSSDOffset(pids[r_b]), (r_e - r_b) * PAGE_SIZE);
+      r_b = r_e;
+   }
+   for (const PID pid : pids) {
+      getPartition(pid).trimmedPage(pid);
+   }
+   PPCounters::myCounters().trimmed_pages_counter += pids.size();
+}
+// -------------------------------------------------------------------------------------
+// Preallocates the data file of pid up to the next chunk boundary behind it, a block device fails to allocate and disables growing
+void BufferManager::ensureSSDSpace(PID pid)
+{
+   SSD& ssd = getSSD(pid);
+   const u64 end = getSSDOffset(pid) + PAGE_SIZE;
+   if (end <= ssd.preallocated_end) {
+      return;
+   }
+   std::unique_lock<std::mutex> guard(ssd.grow_mutex);
+   if (end <= ssd.preallocated_end) {
+      return;
+   }
+   const u64 chunk_size = FLAGS_ssd_grow_gib * 1024ull * 1024ull * 1024ull;
+   const u64 new_end = (end + chunk_size - 1) / chunk_size * chunk_size;
+   if (ssd.device->allocate(ssd.preallocated_end, new_end - ssd.preallocated_end)) {
+      ssd.preallocated_end = new_end;
+   } else {
+      ssd.preallocated_end = std::numeric_limits<u64>::max();
+   }
 }
 // -------------------------------------------------------------------------------------
 void BufferManager::writeAllBufferFrames()
@@ -135,8 +423,8 @@ void BufferManager::writeAllBufferFrames()
          if (!bf.isFree()) {
             page.dt_id = bf.page.dt_id;
             page.magic_debugging_number = bf.header.pid;
-            DTRegistry::global_dt_registry.checkpoint(bf.page.dt_id, bf, page.dt);
-            s64 ret = pwrite(ssd_fd, page, PAGE_SIZE, bf.header.pid * PAGE_SIZE);
+            getDTRegistry().checkpoint(bf.page.dt_id, bf, page.dt);
+            s64 ret = getSSD(bf.header.pid).device->write(page, PAGE_SIZE, getSSDOffset(bf.header.pid));
             ensure(ret == PAGE_SIZE);
          }
          bf.header.latch.mutex.unlock();
@@ -156,7 +444,7 @@ u64 BufferManager::consumedPages()
 // -------------------------------------------------------------------------------------
 BufferFrame& BufferManager::getContainingBufferFrame(const u8* ptr)
 {
-   u64 index = (ptr - reinterpret_cast<u8*>(bfs)) / (sizeof(BufferFrame));
+   u64 index = (ptr - reinterpret_cast<u8*>(pages)) / (sizeof(BufferFrame::Page));
    return bfs[index];
 }
 // -------------------------------------------------------------------------------------
@@ -181,6 +469,9 @@ BufferFrame& BufferManager::allocatePage()
    Partition& partition = randomPartition();
    BufferFrame& free_bf = partition.dram_free_list.tryPop();
    PID free_pid = partition.nextPID();
+   if (FLAGS_ssd_grow_gib) {
+      ensureSSDSpace(free_pid);
+   }
    assert(free_bf.header.state == BufferFrame::STATE::FREE);
    // -------------------------------------------------------------------------------------
    // Initialize Buffer Frame
@@ -197,6 +488,22 @@ BufferFrame& BufferManager::allocatePage()
    return free_bf;
 }
 // -------------------------------------------------------------------------------------
+// Below half of its free frames target, a partition makes the workers wait in proportion to the missing frames,
+// so they slow down smoothly instead of jumping on the empty free list while the page providers catch up.
+// Never called under a latch: allocatePage runs during splits with the tree latched, so the workers wait at the start
+// of their transactions and in resolveSwip after releasing the swip instead
+void BufferManager::applyBackpressure(Partition& partition)
+{
+   const u64 low_watermark = partition.free_bfs_limit / 2;
+   const u64 free_bfs = partition.dram_free_list.counter;
+   if (free_bfs >= low_watermark) {
+      return;
+   }
+   const u64 wait_us = FLAGS_bm_backpressure_us * (low_watermark - free_bfs) / low_watermark;
+   std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+   COUNTERS_BLOCK() { WorkerCounters::myCounters().backpressure_us += wait_us; }
+}
+// -------------------------------------------------------------------------------------
 void BufferManager::evictLastPage()
 {
    if (FLAGS_worker_page_eviction && last_read_bf) {
@@ -242,6 +549,7 @@ void BufferManager::evictLastPage()
          assert(!last_read_bf->header.is_being_written_back);
          assert(last_read_bf->header.state != BufferFrame::STATE::FREE);
          parent_handler.swip.evict(last_pid);
+         getDTRegistry().residentPageRemoved(dt_id);
          // -------------------------------------------------------------------------------------
          // Reclaim buffer frame
          last_read_bf->reset();
@@ -255,18 +563,98 @@ void BufferManager::evictLastPage()
    }
 }
 // -------------------------------------------------------------------------------------
+// Releases a HOT page without HOT children right away instead of waiting for the page provider to sample it,
+// e.g., the scan-only leaves a scan leaves behind: a clean page is evicted and its frame goes back to the free list,
+// so scans keep recycling their own frames, a dirty one is cooled for the page provider to write it back.
+// Gives up silently on contention.
+// parent_guard: an optimistic guard of the parent the caller keeps using, e.g., for a sibling move. When our swip change was the only
+// change of that parent since the guard's version, the version is advanced past it, so the release does not invalidate the guard
+void BufferManager::releasePage(BufferFrame& bf, Guard* parent_guard)
+{
+   jumpmuTry()
+   {
+      BMOptimisticGuard o_guard(bf.header.latch);
+      const bool is_cooling_candidate = (!bf.header.keep_in_memory && !bf.header.is_being_written_back &&
+                                         !(bf.header.latch.isExclusivelyLatched()) && bf.header.state == BufferFrame::STATE::HOT);
+      if (!is_cooling_candidate) {
+         jumpmu::jump();
+      }
+      o_guard.recheck();
+      // -------------------------------------------------------------------------------------
+      bool has_hot_child = false;
+      DTID dt_id = bf.page.dt_id;
+      o_guard.recheck();
+      getDTRegistry().iterateChildrenSwips(dt_id, bf, [&](Swip<BufferFrame>& swip) {
+         has_hot_child |= swip.isHOT();
+         o_guard.recheck();
+         return !has_hot_child;
+      });
+      if (has_hot_child) {
+         jumpmu::jump();
+      }
+      ParentSwipHandler parent_handler = getDTRegistry().findParent(dt_id, bf);
+      // -------------------------------------------------------------------------------------
+      if (FLAGS_optimistic_parent_pointer) {
+         if (parent_handler.is_bf_updated) {
+            o_guard.guard.version += 2;
+         }
+      }
+      // -------------------------------------------------------------------------------------
+      paranoid(parent_handler.parent_guard.state == GUARD_STATE::OPTIMISTIC);
+      const bool is_callers_parent = parent_guard && parent_guard->state == GUARD_STATE::OPTIMISTIC &&
+                                     parent_guard->latch == parent_handler.parent_guard.latch &&
+                                     parent_guard->version == parent_handler.parent_guard.version;
+      o_guard.recheck();
+      if (bf.isDirty()) {
+         BMExclusiveUpgradeIfNeeded p_x_guard(parent_handler.parent_guard);
+         BMExclusiveGuard x_guard(o_guard);
+         paranoid(bf.header.state == BufferFrame::STATE::HOT);
+         paranoid(parent_handler.swip.bf == &bf);
+         bf.header.state = BufferFrame::STATE::COOL;
+         parent_handler.swip.cool();  // Cool the pointing swip before unlocking the current bf
+      } else {
+         BMExclusiveUpgradeIfNeeded p_x_guard(parent_handler.parent_guard);
+         o_guard.guard.toExclusive();
+         // -------------------------------------------------------------------------------------
+         if (FLAGS_crc_check && bf.header.crc) {
+            ensure(utils::CRC(bf.page.dt, EFFECTIVE_PAGE_SIZE) == bf.header.crc);
+         }
+         paranoid(!bf.header.is_being_written_back);
+         paranoid(parent_handler.swip.bf == &bf);
+         const PID evicted_pid = bf.header.pid;
+         parent_handler.swip.evict(evicted_pid);
+         getDTRegistry().residentPageRemoved(dt_id);
+         // -------------------------------------------------------------------------------------
+         // Reclaim buffer frame
+         bf.reset();
+         bf.header.latch->fetch_add(LATCH_EXCLUSIVE_BIT, std::memory_order_release);
+         bf.header.latch.mutex.unlock();
+         FreedBfsBatch freed_bfs_batch;
+         freed_bfs_batch.add(bf);
+         freed_bfs_batch.push(getPartition(evicted_pid));
+      }
+      if (is_callers_parent) {
+         parent_guard->version = parent_handler.parent_guard.version;
+      }
+      COUNTERS_BLOCK() { WorkerCounters::myCounters().dt_released_pages[dt_id]++; }
+   }
+   jumpmuCatch() {}
+}
+// -------------------------------------------------------------------------------------
 // Pre: bf is exclusively locked
 // ATTENTION: this function unlocks it !!
 // -------------------------------------------------------------------------------------
 void BufferManager::reclaimPage(BufferFrame& bf)
 {
    Partition& partition = getPartition(bf.header.pid);
+   getDTRegistry().residentPageRemoved(bf.page.dt_id);
    if (FLAGS_recycle_pages) {
       partition.freePage(bf.header.pid);
    }
    // -------------------------------------------------------------------------------------
    if (bf.header.is_being_written_back) {
-      // DO NOTHING ! we have a garbage collector ;-)
+      // The frame stays with the page provider or the cleaner that writes it, their write completion frees it
+      bf.header.is_reclaimed = true;
       bf.header.latch->fetch_add(LATCH_EXCLUSIVE_BIT, std::memory_order_release);
       bf.header.latch.mutex.unlock();
    } else {
@@ -292,19 +680,24 @@ BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& sw
       BMExclusiveGuard bf_x_guard(bf_guard);                // child
       bf->header.state = BufferFrame::STATE::HOT;
       swip_value.warm();
+      last_swizzled_bf = bf;
       return *bf;
    }
    // -------------------------------------------------------------------------------------
    swip_guard.unlock();  // Otherwise we would get a deadlock, P->G, G->P
    const PID pid = swip_value.asPageID();
    Partition& partition = getPartition(pid);
+   Partition& free_partition = randomPartition();
+   if (FLAGS_bm_backpressure_us) {
+      applyBackpressure(free_partition);  // before we hold the partition mutex
+   }
    JMUW<std::unique_lock<std::mutex>> g_guard(partition.ht_mutex);
    swip_guard.recheck();
    paranoid(!swip_value.isHOT());
    // -------------------------------------------------------------------------------------
    auto frame_handler = partition.io_ht.lookup(pid);
    if (!frame_handler) {
-      BufferFrame& bf = randomPartition().dram_free_list.tryPop();
+      BufferFrame& bf = free_partition.dram_free_list.tryPop();
       IOFrame& io_frame = partition.io_ht.insert(pid);
       bf.header.latch.assertNotExclusivelyLatched();
       // -------------------------------------------------------------------------------------
@@ -335,6 +728,7 @@ BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& sw
       if (FLAGS_crc_check) {
          bf.header.crc = utils::CRC(bf.page.dt, EFFECTIVE_PAGE_SIZE);
       }
+      getDTRegistry().residentPageAdded(bf.page.dt_id);
       // -------------------------------------------------------------------------------------
       jumpmuTry()
       {
@@ -351,6 +745,7 @@ BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& sw
          }
          // -------------------------------------------------------------------------------------
          last_read_bf = &bf;
+         last_swizzled_bf = &bf;
          jumpmu_return bf;
       }
       jumpmuCatch()
@@ -413,6 +808,7 @@ BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& sw
          g_guard->unlock();
          // -------------------------------------------------------------------------------------
          last_read_bf = bf;
+         last_swizzled_bf = bf;
          return *bf;
       }
    }
@@ -428,22 +824,39 @@ BufferFrame& BufferManager::resolveSwip(Guard& swip_guard, Swip<BufferFrame>& sw
 // -------------------------------------------------------------------------------------
 // SSD management
 // -------------------------------------------------------------------------------------
+void BufferManager::prefetchSwip(BufferFrame& parent_bf, u64 parent_version, Swip<BufferFrame>& swip_value)
+{
+   std::unique_lock<std::mutex> guard(prefetch_mutex);
+   if (prefetch_queue.size() >= 4 * FLAGS_prefetch_batch_size) {
+      return;  // the prefetcher is behind, the request would likely be served too late anyway
+   }
+   prefetch_queue.push_back({&parent_bf, parent_version, &swip_value});
+   guard.unlock();
+   prefetch_cv.notify_one();
+}
+// -------------------------------------------------------------------------------------
 void BufferManager::readPageSync(u64 pid, u8* destination)
 {
    paranoid(u64(destination) % 512 == 0);
    s64 bytes_left = PAGE_SIZE;
    do {
-      const int bytes_read = pread(ssd_fd, destination, bytes_left, pid * PAGE_SIZE + (PAGE_SIZE - bytes_left));
+      const int bytes_read = getSSD(pid).device->read(destination, bytes_left, getSSDOffset(pid) + (PAGE_SIZE - bytes_left));
       assert(bytes_read > 0);  // call was successfull?
       bytes_left -= bytes_read;
    } while (bytes_left > 0);
    // -------------------------------------------------------------------------------------
-   COUNTERS_BLOCK() { WorkerCounters::myCounters().read_operations_counter++; }
+   COUNTERS_BLOCK()
+   {
+      WorkerCounters::myCounters().read_operations_counter++;
+      WorkerCounters::myCounters().ssd_reads[getSSDID(pid)]++;
+   }
 }
 // -------------------------------------------------------------------------------------
 void BufferManager::fDataSync()
 {
-   fdatasync(ssd_fd);
+   for (auto& ssd : ssds) {
+      ssd->device->sync();
+   }
 }
 // -------------------------------------------------------------------------------------
 u64 BufferManager::getPartitionID(PID pid)
@@ -469,11 +882,11 @@ BufferManager::~BufferManager()
 {
    stopBackgroundThreads();
    // -------------------------------------------------------------------------------------
-   const u64 dram_total_size = sizeof(BufferFrame) * (dram_pool_size + safety_pages);
-   munmap(bfs, dram_total_size);
+   const u64 dram_total_size = (sizeof(BufferFrame) + sizeof(BufferFrame::Page)) * (dram_pool_size + safety_pages);
+   munmap(pages, dram_total_size);
 }
 // -------------------------------------------------------------------------------------
-BufferManager* BMC::global_bf(nullptr);
+thread_local BufferManager* BMC::global_bf(nullptr);
 }  // namespace storage
 }  // namespace leanstore
 // -------------------------------------------------------------------------------------
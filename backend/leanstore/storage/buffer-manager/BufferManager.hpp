@@ -6,12 +6,13 @@
 #include "Partition.hpp"
 #include "Swip.hpp"
 #include "Units.hpp"
+#include "leanstore/storage/io/StorageDevice.hpp"
 // -------------------------------------------------------------------------------------
 #include "PerfEvent.hpp"
 // -------------------------------------------------------------------------------------
-#include <libaio.h>
 #include <sys/mman.h>
 
+#include <condition_variable>
 #include <cstring>
 #include <list>
 #include <mutex>
@@ -74,8 +75,20 @@ class BufferManager
    friend class leanstore::profiling::BMTable;
    // -------------------------------------------------------------------------------------
    BufferFrame* bfs;
-   // -------------------------------------------------------------------------------------
-   const int ssd_fd;
+   BufferFrame::Page* pages;  // bfs[i].page == pages[i]
+   std::unique_ptr<BufferFrame::OptimisticParentPointer[]> optimistic_parent_pointers;  // only with FLAGS_optimistic_parent_pointer
+   // -------------------------------------------------------------------------------------
+   // Data devices: partition p_i lives on ssds[p_i % ssds_count], where its pages are packed densely at pid / ssds_count.
+   // The out-of-place and recycled PIDs of a partition hence never change the device
+   struct SSD {
+      io::StorageDevice* device;
+      // The data file grows in preallocated chunks
+      std::mutex grow_mutex;
+      atomic<u64> preallocated_end = 0;
+   };
+   std::vector<std::unique_ptr<SSD>> ssds;
+   u64 ssds_count;
+   DTRegistry dt_registry;
    // -------------------------------------------------------------------------------------
    // Free  Pages
    const u8 safety_pages = 10;               // we reserve these extra pages to prevent segfaults
@@ -87,28 +100,58 @@ class BufferManager
    u64 partitions_mask;
    std::vector<std::unique_ptr<Partition>> partitions;
    std::atomic<u64> clock_cursor = 0;
+   // Drawn anew by every serialize() and stored in the catalog and in the free space map, a map of another generation is stale
+   u64 state_generation = 0;
 
    // -------------------------------------------------------------------------------------
    // Threads managements
    void pageProviderThread(u64 p_begin, u64 p_end);  // [p_begin, p_end)
+   void prefetchThread();
+   void pageCleanerThread();
    atomic<u64> bg_threads_counter = 0;
    atomic<bool> bg_threads_keep_running = true;
    // -------------------------------------------------------------------------------------
+   // Prefetching: the swip is only trusted as long as the parent version did not change
+   struct PrefetchRequest {
+      BufferFrame* parent_bf;
+      u64 parent_version;
+      Swip<BufferFrame>* swip;
+   };
+   std::mutex prefetch_mutex;
+   std::condition_variable prefetch_cv;
+   std::vector<PrefetchRequest> prefetch_queue;
+   // -------------------------------------------------------------------------------------
+   // SSD space: the oldest freed pages are trimmed, the data files grow in preallocated chunks
+   void trimFreedPages(u64 p_begin, u64 p_end);
+   // Workers wait a little before taking a frame from a partition that runs short of free frames
+   void applyBackpressure(Partition& partition);
+   void ensureSSDSpace(PID pid);
+   // -------------------------------------------------------------------------------------
    // Misc
    Partition& randomPartition();
    BufferFrame& randomBufferFrame();
    Partition& getPartition(PID);
    u64 getPartitionID(PID);
+   u64 getSSDID(PID pid) { return pid % ssds_count; }
+   SSD& getSSD(PID pid) { return *ssds[getSSDID(pid)]; }
+   u64 getSSDOffset(PID pid) { return pid / ssds_count * PAGE_SIZE; }
+   // Groups the PIDs by device, the pages of one device are then in offset order
+   bool ssdOrder(PID a, PID b) { return std::make_pair(getSSDID(a), a) < std::make_pair(getSSDID(b), b); }
    // -------------------------------------------------------------------------------------
    // Temporary hack: let workers evict the last page they used
    static thread_local BufferFrame* last_read_bf;
 
   public:
+   // Last frame swizzled in (loaded or warmed up) by resolveSwip on this thread, used by the scans to recognize the leaves they bring in
+   static thread_local BufferFrame* last_swizzled_bf;
    // -------------------------------------------------------------------------------------
-   BufferManager(s32 ssd_fd);
+   BufferManager(const std::vector<io::StorageDevice*>& ssd_devices);
    ~BufferManager();
    // -------------------------------------------------------------------------------------
    BufferFrame& allocatePage();
+   void releasePage(BufferFrame& bf, Guard* parent_guard = nullptr);
+   // Backpressure of the allocations, called by the workers before a transaction while they hold no latch
+   void applyBackpressure() { applyBackpressure(randomPartition()); }
    inline BufferFrame& tryFastResolveSwip(Guard& swip_guard, Swip<BufferFrame>& swip_value)
    {
       if (swip_value.isHOT()) {
@@ -120,6 +163,8 @@ class BufferManager
       }
    }
    BufferFrame& resolveSwip(Guard& swip_guard, Swip<BufferFrame>& swip_value);
+   // Returns at once, the prefetcher thread reads the evicted page and swizzles it in if the parent did not change meanwhile
+   void prefetchSwip(BufferFrame& parent_bf, u64 parent_version, Swip<BufferFrame>& swip_value);
    void evictLastPage();
    void reclaimPage(BufferFrame& bf);
    // -------------------------------------------------------------------------------------
@@ -141,17 +186,29 @@ class BufferManager
    void writeAllBufferFrames();
    std::unordered_map<std::string, std::string> serialize();
    void deserialize(std::unordered_map<std::string, std::string> map);
+   // Warm restart: recordHotPages dumps the PIDs of the hot frames, warmUp reloads them top-down with large sequential reads
+   // and swizzles them into their parents. warmUp must run before any worker or background thread
+   void recordHotPages(const std::string& path);
+   u64 warmUp(const std::string& path);
+   // The free space map (freed and trimmed PIDs) is persisted next to the state, otherwise every restart would leak the freed pages.
+   // recordFreePages must run after the page providers stopped and after serialize(). loadFreePages ignores a map whose generation
+   // differs from the catalog's (e.g., a crash between writing both): it would hand out PIDs that are live in the catalog's trees
+   void recordFreePages(const std::string& path);
+   u64 loadFreePages(const std::string& path);
    // -------------------------------------------------------------------------------------
    u64 getPoolSize() { return dram_pool_size; }
-   DTRegistry& getDTRegistry() { return DTRegistry::global_dt_registry; }
+   u64 getSSDsCount() { return ssds_count; }
+   DTRegistry& getDTRegistry() { return dt_registry; }
    u64 consumedPages();
    BufferFrame& getContainingBufferFrame(const u8*);  // get the buffer frame containing the given ptr address
+   // The optimistic parent pointer of a frame lives in a side array indexed like bfs
+   inline BufferFrame::OptimisticParentPointer& optimisticParentPointer(BufferFrame& bf) { return optimistic_parent_pointers[&bf - bfs]; }
 };                                                    // namespace storage
 // -------------------------------------------------------------------------------------
 class BMC
 {
   public:
-   static BufferManager* global_bf;
+   static thread_local BufferManager* global_bf;  // The buffer pool of the instance this thread works for
 };
 }  // namespace storage
 }  // namespace leanstore
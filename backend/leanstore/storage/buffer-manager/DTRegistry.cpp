@@ -1,5 +1,7 @@
 #include "DTRegistry.hpp"
 
+#include "Exceptions.hpp"
+#include "leanstore/Config.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
@@ -9,8 +11,6 @@ namespace leanstore
 namespace storage
 {
 // -------------------------------------------------------------------------------------
-DTRegistry DTRegistry::global_dt_registry;
-// -------------------------------------------------------------------------------------
 void DTRegistry::iterateChildrenSwips(DTID dtid, BufferFrame& bf, std::function<bool(Swip<BufferFrame>&)> callback)
 {
    auto dt_meta = dt_instances_ht[dtid];
@@ -48,6 +48,10 @@ void DTRegistry::registerDatastructureInstance(DTType type, void* root_object, s
 {
    std::unique_lock guard(mutex);
    dt_instances_ht.insert({dt_id, {type, root_object, name}});
+   eviction_priorities[dt_id] = (name.substr(0, 1) == "_") ? 0 : FLAGS_bm_tree_priority;
+   if (name.substr(0, 1) == "_" && FLAGS_bm_internal_quota_pct) {
+      dt_quota_group[dt_id] = internal_quota_group;
+   }
    if (dt_id >= instances_counter) {
       instances_counter = dt_id + 1;
    }
@@ -58,9 +62,43 @@ DTID DTRegistry::registerDatastructureInstance(DTType type, void* root_object, s
    std::unique_lock guard(mutex);
    DTID new_instance_id = instances_counter++;
    dt_instances_ht.insert({new_instance_id, {type, root_object, name}});
+   eviction_priorities[new_instance_id] = (name.substr(0, 1) == "_") ? 0 : FLAGS_bm_tree_priority;
+   if (name.substr(0, 1) == "_" && FLAGS_bm_internal_quota_pct) {
+      dt_quota_group[new_instance_id] = internal_quota_group;
+   }
    return new_instance_id;
 }
 // -------------------------------------------------------------------------------------
+void DTRegistry::setEvictionPriority(DTID dt_id, u8 priority)
+{
+   std::unique_lock guard(mutex);
+   eviction_priorities[dt_id] = priority;
+}
+// -------------------------------------------------------------------------------------
+u8 DTRegistry::getEvictionPriority(DTID dt_id)
+{
+   auto iter = eviction_priorities.find(dt_id);
+   return (iter == eviction_priorities.end()) ? 0 : iter->second;
+}
+// -------------------------------------------------------------------------------------
+// Moves the resident pages of the DT to the new group, racing page loads/evictions only skew the group counters slightly
+void DTRegistry::setQuotaGroup(DTID dt_id, u16 group)
+{
+   ensure(group < max_quota_groups);
+   std::unique_lock guard(mutex);
+   const u16 old_group = dt_quota_group[dt_id].exchange(group);
+   const s64 resident_pages = dt_resident_pages[dt_id];
+   quota_groups[old_group].resident_pages -= resident_pages;
+   quota_groups[group].resident_pages += resident_pages;
+}
+// -------------------------------------------------------------------------------------
+void DTRegistry::setQuota(u16 group, u64 soft_pages, u64 hard_pages)
+{
+   ensure(group > 0 && group < max_quota_groups);
+   quota_groups[group].soft_pages = soft_pages;
+   quota_groups[group].hard_pages = hard_pages;
+}
+// -------------------------------------------------------------------------------------
 void DTRegistry::undo(DTID dt_id, const u8* wal_entry, u64 tts)
 {
    auto dt_meta = dt_instances_ht[dt_id];
@@ -2,8 +2,10 @@
 #include "BMPlainGuard.hpp"
 #include "BufferFrame.hpp"
 #include "Units.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <tuple>
@@ -53,12 +55,53 @@ struct DTRegistry {
    s64 instances_counter = 0;
    std::unordered_map<DTType, DTMeta> dt_types_ht;
    std::unordered_map<DTID, std::tuple<DTType, void*, string>> dt_instances_ht;
-   static DTRegistry global_dt_registry;
+   std::unordered_map<DTID, u8> eviction_priorities;
    // -------------------------------------------------------------------------------------
    void registerDatastructureType(DTType type, DTRegistry::DTMeta dt_meta);
    DTID registerDatastructureInstance(DTType type, void* root_object, string name);
    void registerDatastructureInstance(DTType type, void* root_object, string name, DTID dt_id);
    // -------------------------------------------------------------------------------------
+   // Eviction priority classes: the page provider cools a page of priority p on one out of p+1 samples
+   void setEvictionPriority(DTID dt_id, u8 priority);
+   u8 getEvictionPriority(DTID dt_id);
+   // -------------------------------------------------------------------------------------
+   // Memory quotas: every DT belongs to a quota group (0 = no quota) and its resident frames are accounted per DT and per group.
+   // The page provider cools the pages of groups above their soft quota first and keeps cooling groups above their hard quota
+   // even when the free lists are full
+   static constexpr u16 max_quota_groups = 64;
+   static constexpr u16 internal_quota_group = 1;  // "_" trees when FLAGS_bm_internal_quota_pct is set
+   struct QuotaGroup {
+      atomic<s64> resident_pages = 0;
+      atomic<u64> soft_pages = 0;  // 0 = unlimited
+      atomic<u64> hard_pages = 0;  // 0 = unlimited
+   };
+   QuotaGroup quota_groups[max_quota_groups];
+   atomic<u16> dt_quota_group[WorkerCounters::max_dt_id] = {};
+   atomic<s64> dt_resident_pages[WorkerCounters::max_dt_id] = {};
+   void setQuotaGroup(DTID dt_id, u16 group);
+   void setQuota(u16 group, u64 soft_pages, u64 hard_pages);
+   inline void residentPageAdded(DTID dt_id)
+   {
+      dt_resident_pages[dt_id]++;
+      quota_groups[dt_quota_group[dt_id]].resident_pages++;
+   }
+   inline void residentPageRemoved(DTID dt_id)
+   {
+      dt_resident_pages[dt_id]--;
+      quota_groups[dt_quota_group[dt_id]].resident_pages--;
+   }
+   inline bool isOverSoftQuota(u16 group)
+   {
+      const s64 resident_pages = quota_groups[group].resident_pages;
+      const u64 soft_pages = quota_groups[group].soft_pages, hard_pages = quota_groups[group].hard_pages;
+      return (soft_pages && resident_pages > s64(soft_pages)) || (hard_pages && resident_pages > s64(hard_pages));
+   }
+   inline bool isOverHardQuota(u16 group)
+   {
+      const u64 hard_pages = quota_groups[group].hard_pages;
+      return hard_pages && quota_groups[group].resident_pages > s64(hard_pages);
+   }
+   // -------------------------------------------------------------------------------------
    void iterateChildrenSwips(DTID dtid, BufferFrame&, std::function<bool(Swip<BufferFrame>&)>);
    ParentSwipHandler findParent(DTID dtid, BufferFrame&);
    SpaceCheckResult checkSpaceUtilization(DTID dtid, BufferFrame&);
@@ -0,0 +1,170 @@
+#include "AsyncWriteBuffer.hpp"
+#include "BufferFrame.hpp"
+#include "BufferManager.hpp"
+#include "Exceptions.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+#include "leanstore/profiling/counters/PPCounters.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/utils/Misc.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <chrono>
+#include <thread>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+// -------------------------------------------------------------------------------------
+// Writes dirty frames back ahead of eviction, so phase 2 of the page providers finds them clean and frees them at once.
+// The cleaner sweeps the pool chunk by chunk, the dirty share of the resident frames in a chunk estimates the dirty ratio.
+// Above FLAGS_bm_dirty_target_pct it writes the excess: first the cooling frames (next to be evicted), then the ones the
+// page providers cool first (left behind by scans or over their quota), then the remaining hot ones.
+// The pages are written in place with the same protocol as phase 2: is_being_written_back is set and cleared under the exclusive latch.
+// Inner nodes are only written once their children are evicted, hence the cleaner mostly writes leaves
+void BufferManager::pageCleanerThread()
+{
+   pthread_setname_np(pthread_self(), "page_cleaner");
+   leanstore::cr::CRManager::global->registerMeAsSpecialWorker();
+   // -------------------------------------------------------------------------------------
+   std::vector<std::unique_ptr<AsyncWriteBuffer>> async_write_buffers;
+   for (auto& ssd : ssds) {
+      async_write_buffers.push_back(std::make_unique<AsyncWriteBuffer>(*ssd->device, PAGE_SIZE, FLAGS_write_buffer_size));
+   }
+   const u64 chunk_size = std::min<u64>(dram_pool_size, 8 * FLAGS_write_buffer_size);
+   constexpr u64 priorities_count = 3;
+   std::vector<BufferFrame*> candidates[priorities_count];
+   volatile u64 bf_cursor = 0;  // The locals of the loop that live across its jumpmu checkpoints are volatile
+   // -------------------------------------------------------------------------------------
+   auto handle_written_bf = [&](BufferFrame& written_bf, u64 written_lsn, PID) {
+      jumpmuTry()
+      {
+         Partition* reclaimed_in_partition = nullptr;
+         {
+            BMOptimisticGuard o_guard(written_bf.header.latch);
+            BMExclusiveGuard ex_guard(o_guard);
+            ensure(written_bf.header.is_being_written_back);
+            ensure(written_bf.header.last_written_plsn < written_lsn);
+            written_bf.header.last_written_plsn = written_lsn;
+            written_bf.header.is_being_written_back = false;
+            PPCounters::myCounters().cleaned_pages_counter++;
+            if (written_bf.header.is_reclaimed) {  // Merged away while we wrote it, reclaimPage left the frame to us
+               reclaimed_in_partition = &getPartition(written_bf.header.pid);
+               written_bf.reset();
+            }
+         }
+         if (reclaimed_in_partition) {
+            reclaimed_in_partition->dram_free_list.push(written_bf);
+         }
+      }
+      jumpmuCatch()
+      {
+         written_bf.header.crc = 0;
+         if (written_bf.header.is_reclaimed) {
+            // Nobody else would ever free it, hence wait for the latch instead of wasting the write
+            Guard bf_guard(written_bf.header.latch);
+            bf_guard.toExclusive();
+            Partition& partition = getPartition(written_bf.header.pid);
+            written_bf.header.is_being_written_back.store(false, std::memory_order_release);
+            written_bf.reset();
+            bf_guard.unlock();
+            partition.dram_free_list.push(written_bf);
+         } else {
+            written_bf.header.is_being_written_back.store(false, std::memory_order_release);
+         }
+      }
+   };
+   // -------------------------------------------------------------------------------------
+   while (bg_threads_keep_running) {
+      u64 resident_bfs = 0, dirty_bfs = 0;
+      for (u64 bf_i = 0; bf_i < chunk_size; bf_i++) {
+         BufferFrame& bf = bfs[bf_cursor];
+         bf_cursor = (bf_cursor + 1) % dram_pool_size;
+         // Racy reads, the candidates are checked again under their latch
+         const BufferFrame::STATE state = bf.header.state;
+         if (state != BufferFrame::STATE::HOT && state != BufferFrame::STATE::COOL) {
+            continue;
+         }
+         resident_bfs++;
+         if (!bf.isDirty() || bf.header.is_being_written_back) {
+            continue;
+         }
+         dirty_bfs++;
+         const DTID dt_id = bf.page.dt_id;
+         if (state == BufferFrame::STATE::COOL) {
+            candidates[0].push_back(&bf);
+         } else if (bf.header.is_scan_only ||
+                    (dt_id >= 0 && u64(dt_id) < WorkerCounters::max_dt_id &&
+                     getDTRegistry().isOverSoftQuota(getDTRegistry().dt_quota_group[dt_id]))) {
+            candidates[1].push_back(&bf);
+         } else {
+            candidates[2].push_back(&bf);
+         }
+      }
+      const u64 target_dirty_bfs = resident_bfs * FLAGS_bm_dirty_target_pct / 100.0;
+      volatile u64 excess_bfs = (dirty_bfs > target_dirty_bfs) ? dirty_bfs - target_dirty_bfs : 0;
+      // -------------------------------------------------------------------------------------
+      for (volatile u64 p_i = 0; p_i < priorities_count;) {
+         for (BufferFrame* bf : candidates[p_i]) {
+            if (excess_bfs == 0) {
+               break;
+            }
+            jumpmuTry()
+            {
+               BMOptimisticGuard o_guard(bf->header.latch);
+               const BufferFrame::STATE state = bf->header.state;
+               if ((state != BufferFrame::STATE::HOT && state != BufferFrame::STATE::COOL) || !bf->isDirty() || bf->header.is_being_written_back) {
+                  jumpmu_continue;
+               }
+               // Like phase 2, only pages without swizzled children: a written swizzled swip would be a dangling pointer on disk
+               bool all_children_evicted = true;
+               getDTRegistry().iterateChildrenSwips(bf->page.dt_id, *bf, [&](Swip<BufferFrame>& swip) {
+                  all_children_evicted &= swip.isEVICTED();
+                  o_guard.recheck();
+                  return all_children_evicted;
+               });
+               if (!all_children_evicted) {
+                  jumpmu_continue;
+               }
+               const PID pid = bf->header.pid;
+               o_guard.recheck();
+               AsyncWriteBuffer& async_write_buffer = *async_write_buffers[getSSDID(pid)];
+               if (async_write_buffer.full()) {
+                  jumpmu_continue;
+               }
+               BMExclusiveGuard ex_guard(o_guard);
+               bf->header.is_being_written_back.store(true, std::memory_order_release);
+               if (FLAGS_crc_check) {
+                  bf->header.crc = utils::CRC(bf->page.dt, EFFECTIVE_PAGE_SIZE);
+               }
+               async_write_buffer.add(*bf, pid, getSSDOffset(pid));
+               excess_bfs = excess_bfs - 1;
+            }
+            jumpmuCatch() {}
+         }
+         candidates[p_i].clear();
+         p_i = p_i + 1;
+      }
+      // -------------------------------------------------------------------------------------
+      u64 written_bfs = 0;
+      for (auto& async_write_buffer : async_write_buffers) {
+         async_write_buffer->submit();
+      }
+      for (u64 ssd_i = 0; ssd_i < ssds_count; ssd_i++) {
+         const u32 polled_events = async_write_buffers[ssd_i]->pollEventsSync();
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().ssd_writes[ssd_i] += polled_events; }
+         async_write_buffers[ssd_i]->getWrittenBfs(handle_written_bf, polled_events);
+         written_bfs += polled_events;
+      }
+      if (written_bfs == 0) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+   }
+   bg_threads_counter--;
+}
+// -------------------------------------------------------------------------------------
+}  // namespace storage
+}  // namespace leanstore
+// -------------------------------------------------------------------------------------
@@ -34,7 +34,11 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
    leanstore::cr::CRManager::global->registerMeAsSpecialWorker();
    // -------------------------------------------------------------------------------------
    // Init AIO Context
-   AsyncWriteBuffer async_write_buffer(ssd_fd, PAGE_SIZE, FLAGS_write_buffer_size);
+   // One write buffer per data device, the devices are written in parallel
+   std::vector<std::unique_ptr<AsyncWriteBuffer>> async_write_buffers;
+   for (auto& ssd : ssds) {
+      async_write_buffers.push_back(std::make_unique<AsyncWriteBuffer>(*ssd->device, PAGE_SIZE, FLAGS_write_buffer_size));
+   }
    std::vector<BufferFrame*> cool_candidate_bfs, evict_candidate_bfs;
    // -------------------------------------------------------------------------------------
    auto next_bf_range = [&]() {
@@ -48,6 +52,11 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
       return;
    };
    // -------------------------------------------------------------------------------------
+   // Steady clock ns of the next trim, volatile since it lives across the jumpmu checkpoints of the rounds
+   volatile u64 next_trim_ns = 0;
+   auto now_ns = []() -> u64 {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   };
    while (bg_threads_keep_running) {
       // Phase 1: unswizzle pages (put in the cooling stage)
       // -------------------------------------------------------------------------------------
@@ -61,7 +70,15 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
       jumpmu_continue;                       \
    }
       auto& current_partition = randomPartition();
-      if ((current_partition.dram_free_list.counter < current_partition.free_bfs_limit) && failed_attempts < 10) {
+      // Quota groups above their soft quota are cooled first, the ones above their hard quota even when the free list is full
+      volatile bool any_over_soft_quota = false;  // read inside the jumpmu blocks below
+      bool any_over_hard_quota = false;
+      for (u16 group = 1; group < DTRegistry::max_quota_groups; group++) {
+         any_over_soft_quota = any_over_soft_quota || getDTRegistry().isOverSoftQuota(group);
+         any_over_hard_quota |= getDTRegistry().isOverHardQuota(group);
+      }
+      const bool free_list_short = current_partition.dram_free_list.counter < current_partition.free_bfs_limit;
+      if ((free_list_short || any_over_hard_quota) && failed_attempts < 10) {
          next_bf_range();
          while (cool_candidate_bfs.size()) {
             jumpmuTry()
@@ -79,7 +96,18 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
                   repickIf(true);  // TODO: maybe without failed_attempts
                }
                repickIf(r_buffer->header.state != BufferFrame::STATE::HOT);
+               const u8 eviction_priority = getDTRegistry().getEvictionPriority(r_buffer->page.dt_id);
+               const DTID r_dt_id = r_buffer->page.dt_id;
+               const bool r_over_quota = r_dt_id >= 0 && u64(r_dt_id) < WorkerCounters::max_dt_id &&
+                                         getDTRegistry().isOverSoftQuota(getDTRegistry().dt_quota_group[r_dt_id]);
+               const bool r_scan_only = r_buffer->header.is_scan_only;  // scans left it behind, cool it first
                r_guard.recheck();
+               if (any_over_soft_quota && !r_over_quota) {
+                  // Spare the groups within their quota: always when only a hard quota triggered the round, else 3 out of 4 times
+                  repickIf(!free_list_short || utils::RandomGenerator::getRandU64(0, 4) != 0);
+               }
+               repickIf(!r_over_quota && !r_scan_only && eviction_priority > 0 &&
+                        utils::RandomGenerator::getRandU64(0, eviction_priority + 1) != 0);
                // -------------------------------------------------------------------------------------
                COUNTERS_BLOCK() { PPCounters::myCounters().touched_bfs_counter++; }
                // -------------------------------------------------------------------------------------
@@ -194,6 +222,7 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
          // -------------------------------------------------------------------------------------
          const PID evicted_pid = bf.header.pid;
          parent_handler.swip.evict(evicted_pid);
+         getDTRegistry().residentPageRemoved(dt_id);
          // -------------------------------------------------------------------------------------
          // Reclaim buffer frame
          bf.reset();
@@ -238,6 +267,7 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
                }
             }
             if (cooled_bf->isDirty()) {
+               AsyncWriteBuffer& async_write_buffer = *async_write_buffers[getSSDID(cooled_bf_pid)];
                if (!async_write_buffer.full()) {
                   {
                      BMExclusiveGuard ex_guard(o_guard);
@@ -250,13 +280,16 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
                      PID wb_pid = cooled_bf_pid;
                      if (FLAGS_out_of_place) {
                         wb_pid = getPartition(cooled_bf_pid).nextPID();
+                        if (FLAGS_ssd_grow_gib) {
+                           ensureSSDSpace(wb_pid);
+                        }
                         paranoid(getPartitionID(cooled_bf->header.pid) == p_i);
                         paranoid(getPartitionID(wb_pid) == p_i);
                      }
-                     async_write_buffer.add(*cooled_bf, wb_pid);
+                     async_write_buffer.add(*cooled_bf, wb_pid, getSSDOffset(wb_pid));
                   }
                } else {
-                  jumpmu_break;
+                  jumpmu_continue;  // the pages of the other devices may still fit
                }
             } else {
                evict_bf(*cooled_bf, o_guard);
@@ -267,52 +300,75 @@ void BufferManager::pageProviderThread(u64 p_begin, u64 p_end)  // [p_begin, p_e
       evict_candidate_bfs.clear();
       // -------------------------------------------------------------------------------------
       // Phase 3:
-      if (async_write_buffer.submit()) {
-         const u32 polled_events = async_write_buffer.pollEventsSync();
-         async_write_buffer.getWrittenBfs(
-             [&](BufferFrame& written_bf, u64 written_lsn, PID out_of_place_pid) {
-                jumpmuTry()
-                {
-                   // When the written back page is being exclusively locked, we should rather waste the write and move on to another page
-                   // Instead of waiting on its latch because of the likelihood that a data structure implementation keeps holding a parent latch
-                   // while trying to acquire a new page
-                   {
-                      BMOptimisticGuard o_guard(written_bf.header.latch);
-                      BMExclusiveGuard ex_guard(o_guard);
-                      ensure(written_bf.header.is_being_written_back);
-                      ensure(written_bf.header.last_written_plsn < written_lsn);
-                      // -------------------------------------------------------------------------------------
-                      if (FLAGS_out_of_place) {  // For recovery, so much has to be done here...
-                         getPartition(getPartitionID(written_bf.header.pid)).freePage(written_bf.header.pid);
-                         written_bf.header.pid = out_of_place_pid;
-                      }
-                      written_bf.header.last_written_plsn = written_lsn;
-                      written_bf.header.is_being_written_back = false;
-                      PPCounters::myCounters().flushed_pages_counter++;
-                   }
-                }
-                jumpmuCatch()
-                {
-                   written_bf.header.crc = 0;
-                   written_bf.header.is_being_written_back.store(false, std::memory_order_release);
-                }
-                // -------------------------------------------------------------------------------------
-                {
-                   jumpmuTry()
-                   {
-                      BMOptimisticGuard o_guard(written_bf.header.latch);
-                      if (written_bf.header.state == BufferFrame::STATE::COOL && !written_bf.header.is_being_written_back && !written_bf.isDirty()) {
-                         evict_bf(written_bf, o_guard);
-                      }
-                   }
-                   jumpmuCatch() {}
-                }
-             },
-             polled_events);
+      auto handle_written_bf = [&](BufferFrame& written_bf, u64 written_lsn, PID out_of_place_pid) {
+         jumpmuTry()
+         {
+            // When the written back page is being exclusively locked, we should rather waste the write and move on to another page
+            // Instead of waiting on its latch because of the likelihood that a data structure implementation keeps holding a parent latch
+            // while trying to acquire a new page
+            {
+               BMOptimisticGuard o_guard(written_bf.header.latch);
+               BMExclusiveGuard ex_guard(o_guard);
+               ensure(written_bf.header.is_being_written_back);
+               ensure(written_bf.header.last_written_plsn < written_lsn);
+               // -------------------------------------------------------------------------------------
+               if (FLAGS_out_of_place) {  // For recovery, so much has to be done here...
+                  getPartition(getPartitionID(written_bf.header.pid)).freePage(written_bf.header.pid);
+                  written_bf.header.pid = out_of_place_pid;
+               }
+               written_bf.header.last_written_plsn = written_lsn;
+               written_bf.header.is_being_written_back = false;
+               PPCounters::myCounters().flushed_pages_counter++;
+               if (written_bf.header.is_reclaimed) {  // Merged away while we wrote it, reclaimPage left the frame to us
+                  written_bf.reset();
+                  freed_bfs_batch.add(written_bf);
+               }
+            }
+         }
+         jumpmuCatch()
+         {
+            written_bf.header.crc = 0;
+            if (written_bf.header.is_reclaimed) {
+               // Nobody else would ever free it, hence wait for the latch instead of wasting the write
+               Guard bf_guard(written_bf.header.latch);
+               bf_guard.toExclusive();
+               written_bf.header.is_being_written_back.store(false, std::memory_order_release);
+               written_bf.reset();
+               bf_guard.unlock();
+               freed_bfs_batch.add(written_bf);
+            } else {
+               written_bf.header.is_being_written_back.store(false, std::memory_order_release);
+            }
+         }
+         // -------------------------------------------------------------------------------------
+         {
+            jumpmuTry()
+            {
+               BMOptimisticGuard o_guard(written_bf.header.latch);
+               if (written_bf.header.state == BufferFrame::STATE::COOL && !written_bf.header.is_being_written_back && !written_bf.isDirty()) {
+                  evict_bf(written_bf, o_guard);
+               }
+            }
+            jumpmuCatch() {}
+         }
+      };
+      for (auto& async_write_buffer : async_write_buffers) {
+         async_write_buffer->submit();
+      }
+      for (u64 ssd_i = 0; ssd_i < ssds_count; ssd_i++) {
+         const u32 polled_events = async_write_buffers[ssd_i]->pollEventsSync();
+         COUNTERS_BLOCK() { WorkerCounters::myCounters().ssd_writes[ssd_i] += polled_events; }
+         async_write_buffers[ssd_i]->getWrittenBfs(handle_written_bf, polled_events);
       }
       if (freed_bfs_batch.size()) {
          freed_bfs_batch.push(current_partition);
       }
+      // -------------------------------------------------------------------------------------
+      // Trim the long freed pages of our partitions once per second
+      if (FLAGS_ssd_trim_batch && now_ns() >= next_trim_ns) {
+         trimFreedPages(p_begin, p_end);
+         next_trim_ns = now_ns() + 1000 * 1000 * 1000;
+      }
       COUNTERS_BLOCK() { PPCounters::myCounters().pp_thread_rounds++; }
    }
    bg_threads_counter--;
@@ -71,8 +71,9 @@ struct Partition {
    // -------------------------------------------------------------------------------------
    // SSD Pages
    const u64 pid_distance;
-   std::mutex pids_mutex;  // protect free pids vector
-   std::vector<PID> freed_pids;
+   std::mutex pids_mutex;          // protect free pids vectors
+   std::vector<PID> freed_pids;    // oldest first, the most recently freed are reused first
+   std::vector<PID> trimmed_pids;  // freed long ago, their space was handed back to the SSD
    u64 next_pid;
    inline PID nextPID()
    {
@@ -81,6 +82,10 @@ struct Partition {
          const u64 pid = freed_pids.back();
          freed_pids.pop_back();
          return pid;
+      } else if (trimmed_pids.size()) {
+         const u64 pid = trimmed_pids.back();
+         trimmed_pids.pop_back();
+         return pid;
       } else {
          const u64 pid = next_pid;
          next_pid += pid_distance;
@@ -93,11 +98,28 @@ struct Partition {
       std::unique_lock<std::mutex> g_guard(pids_mutex);
       freed_pids.push_back(pid);
    }
+   // Once more than twice the batch wait, moves the oldest batch of freed PIDs to pids, nobody reuses them until they come back through
+   // trimmedPage
+   bool takePagesToTrim(std::vector<PID>& pids, u64 batch)
+   {
+      std::unique_lock<std::mutex> g_guard(pids_mutex);
+      if (freed_pids.size() < 2 * batch) {
+         return false;
+      }
+      pids.insert(pids.end(), freed_pids.begin(), freed_pids.begin() + batch);
+      freed_pids.erase(freed_pids.begin(), freed_pids.begin() + batch);
+      return true;
+   }
+   void trimmedPage(PID pid)
+   {
+      std::unique_lock<std::mutex> g_guard(pids_mutex);
+      trimmed_pids.push_back(pid);
+   }
    u64 allocatedPages() { return next_pid / pid_distance; }
    u64 freedPages()
    {
       std::unique_lock<std::mutex> g_guard(pids_mutex);
-      return freed_pids.size();
+      return freed_pids.size() + trimmed_pids.size();
    }
    // -------------------------------------------------------------------------------------
    Partition(u64 first_pid, u64 pid_distance, u64 free_bfs_limit);
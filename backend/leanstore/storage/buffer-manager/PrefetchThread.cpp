@@ -0,0 +1,181 @@
+#include "BufferFrame.hpp"
+#include "BufferManager.hpp"
+#include "Exceptions.hpp"
+#include "leanstore/Config.hpp"
+#include "leanstore/concurrency-recovery/CRMG.hpp"
+#include "leanstore/profiling/counters/WorkerCounters.hpp"
+#include "leanstore/utils/Misc.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <chrono>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+// -------------------------------------------------------------------------------------
+// Reads evicted pages on behalf of prefetch requests with asynchronous reads, one batch per SSD.
+// A read registers an IOFrame in READING state just like resolveSwip, hence concurrent resolvers of the same pid wait for it.
+// When the read completes, the page is swizzled into the parent if the parent version is still the one seen by the requester,
+// otherwise it is handed over to the waiters (READY) or returned to the free list if nobody waits
+void BufferManager::prefetchThread()
+{
+   pthread_setname_np(pthread_self(), "prefetcher");
+   leanstore::cr::CRManager::global->registerMeAsSpecialWorker();
+   // -------------------------------------------------------------------------------------
+   struct Read {
+      PrefetchRequest request;
+      PID pid;
+      BufferFrame* bf;
+      IOFrame* io_frame;  // stays valid, we hold a reader reference
+      Partition* free_partition;
+   };
+   const u64 batch_max_size = FLAGS_prefetch_batch_size;
+   std::vector<std::unique_ptr<io::AsyncIO>> aios;  // one per SSD
+   for (auto& ssd : ssds) {
+      aios.push_back(ssd->device->createAsyncIO(batch_max_size));
+   }
+   std::vector<u64> ssd_reads(ssds_count);
+   auto events = make_unique<io::IOEvent[]>(batch_max_size);
+   std::vector<PrefetchRequest> requests;
+   std::vector<Read> reads;
+   reads.reserve(batch_max_size);
+   // -------------------------------------------------------------------------------------
+   while (bg_threads_keep_running) {
+      {
+         std::unique_lock<std::mutex> guard(prefetch_mutex);
+         prefetch_cv.wait_for(guard, std::chrono::milliseconds(10), [&]() { return !prefetch_queue.empty(); });
+         const u64 batch_size = std::min<u64>(batch_max_size, prefetch_queue.size());
+         requests.assign(prefetch_queue.end() - batch_size, prefetch_queue.end());
+         prefetch_queue.resize(prefetch_queue.size() - batch_size);
+      }
+      // -------------------------------------------------------------------------------------
+      // Phase 1: register the IO frames and submit the reads
+      reads.clear();
+      for (auto& request : requests) {
+         jumpmuTry()
+         {
+            Guard p_guard(request.parent_bf->header.latch, request.parent_version);
+            const bool evicted = request.swip->isEVICTED();
+            p_guard.recheck();
+            if (!evicted) {
+               jumpmu_continue;
+            }
+            const PID pid = request.swip->asPageID();
+            Partition& partition = getPartition(pid);
+            JMUW<std::unique_lock<std::mutex>> g_guard(partition.ht_mutex);
+            p_guard.recheck();
+            if (partition.io_ht.lookup(pid)) {
+               jumpmu_continue;  // somebody is already reading it
+            }
+            // Leave the second half of the free frames reserve to the synchronous reads
+            Partition& free_partition = randomPartition();
+            if (free_partition.dram_free_list.counter < free_partition.free_bfs_limit / 2) {
+               jumpmu_continue;
+            }
+            BufferFrame& bf = free_partition.dram_free_list.tryPop();
+            IOFrame& io_frame = partition.io_ht.insert(pid);
+            bf.header.latch.assertNotExclusivelyLatched();
+            // -------------------------------------------------------------------------------------
+            io_frame.state = IOFrame::STATE::READING;
+            io_frame.readers_counter = 1;
+            io_frame.mutex.lock();
+            // -------------------------------------------------------------------------------------
+            reads.push_back({request, pid, &bf, &io_frame, &free_partition});
+            aios[getSSDID(pid)]->prepRead(bf.page, PAGE_SIZE, getSSDOffset(pid), &bf);
+            ssd_reads[getSSDID(pid)]++;
+         }
+         jumpmuCatch() {}
+      }
+      if (reads.empty()) {
+         continue;
+      }
+      for (u64 ssd_i = 0; ssd_i < ssds_count; ssd_i++) {
+         const u64 submitted = aios[ssd_i]->submit();
+         ensure(submitted == ssd_reads[ssd_i]);
+      }
+      for (u64 ssd_i = 0; ssd_i < ssds_count; ssd_i++) {
+         u64 completed = 0;
+         while (completed < ssd_reads[ssd_i]) {
+            const u64 done = aios[ssd_i]->poll(ssd_reads[ssd_i] - completed, ssd_reads[ssd_i] - completed, events.get());
+            for (u64 e_i = 0; e_i < done; e_i++) {
+               ensure(events[e_i].result == s64(PAGE_SIZE));
+            }
+            completed += done;
+         }
+         ssd_reads[ssd_i] = 0;  // Reset once drained, a std::fill before phase 1 would be clobbered by the jumpmu checkpoints
+      }
+      // -------------------------------------------------------------------------------------
+      // Phase 2: fill the BFs and swizzle them in
+      for (auto& read : reads) {
+         BufferFrame& bf = *read.bf;
+         const PID pid = read.pid;
+         Partition& partition = getPartition(pid);
+         COUNTERS_BLOCK()
+         {
+            WorkerCounters::myCounters().dt_page_prefetches[bf.page.dt_id]++;
+            WorkerCounters::myCounters().read_operations_counter++;
+            WorkerCounters::myCounters().ssd_reads[getSSDID(pid)]++;
+         }
+         paranoid(bf.page.magic_debugging_number == pid);
+         // -------------------------------------------------------------------------------------
+         // ATTENTION: Fill the BF
+         paranoid(!bf.header.is_being_written_back);
+         bf.header.last_written_plsn = bf.page.PLSN;
+         bf.header.state = BufferFrame::STATE::LOADED;
+         bf.header.pid = pid;
+         if (FLAGS_crc_check) {
+            bf.header.crc = utils::CRC(bf.page.dt, EFFECTIVE_PAGE_SIZE);
+         }
+         getDTRegistry().residentPageAdded(bf.page.dt_id);
+         // -------------------------------------------------------------------------------------
+         IOFrame& io_frame = *read.io_frame;
+         volatile bool swizzled = false;
+         jumpmuTry()
+         {
+            Guard p_guard(read.request.parent_bf->header.latch, read.request.parent_version);
+            JMUW<std::unique_lock<std::mutex>> g_guard(partition.ht_mutex);
+            BMExclusiveUpgradeIfNeeded p_x_guard(p_guard);
+            paranoid(read.request.swip->isEVICTED() && read.request.swip->asPageID() == pid);
+            io_frame.mutex.unlock();
+            read.request.swip->warm(&bf);
+            bf.header.state = BufferFrame::STATE::HOT;  // ATTENTION: SET TO HOT AFTER
+                                                        // IT IS SWIZZLED IN
+            // -------------------------------------------------------------------------------------
+            if (io_frame.readers_counter.fetch_add(-1) == 1) {
+               partition.io_ht.remove(pid);
+            }
+            swizzled = true;
+         }
+         jumpmuCatch() {}
+         if (swizzled) {
+            continue;
+         }
+         // The parent changed meanwhile
+         std::unique_lock<std::mutex> g_guard(partition.ht_mutex);
+         if (io_frame.readers_counter == 1) {
+            io_frame.mutex.unlock();
+            partition.io_ht.remove(pid);
+            g_guard.unlock();
+            // -------------------------------------------------------------------------------------
+            getDTRegistry().residentPageRemoved(bf.page.dt_id);
+            Guard bf_guard(bf.header.latch);
+            bf_guard.toExclusive();
+            bf.reset();
+            bf_guard.unlock();
+            read.free_partition->dram_free_list.push(bf);
+         } else {
+            io_frame.bf = &bf;
+            io_frame.state = IOFrame::STATE::READY;
+            g_guard.unlock();
+            io_frame.mutex.unlock();
+         }
+      }
+   }
+   bg_threads_counter--;
+}
+// -------------------------------------------------------------------------------------
+}  // namespace storage
+}  // namespace leanstore
+// -------------------------------------------------------------------------------------
@@ -0,0 +1,221 @@
+#include "EmulatedDevice.hpp"
+
+#include "Exceptions.hpp"
+#include "leanstore/Config.hpp"
+// -------------------------------------------------------------------------------------
+#include <gflags/gflags.h>
+// -------------------------------------------------------------------------------------
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+// The data is moved at submit, poll only waits until the emulated completion times
+class EmulatedAsyncIO : public AsyncIO
+{
+  private:
+   struct Request {
+      u8* buffer;
+      u64 size;
+      u64 offset;
+      void* data;
+      bool is_write;
+      s64 result;
+      u64 completion_ns;
+   };
+   EmulatedDevice& device;
+   const u64 max_requests;
+   std::vector<Request> prepared, in_flight;
+
+  public:
+   EmulatedAsyncIO(EmulatedDevice& device, u64 max_requests) : device(device), max_requests(max_requests)
+   {
+      prepared.reserve(max_requests);
+      in_flight.reserve(max_requests);
+   }
+   void prepRead(u8* destination, u64 size, u64 offset, void* data) override
+   {
+      ensure(prepared.size() + in_flight.size() < max_requests);
+      prepared.push_back({destination, size, offset, data, false, 0, 0});
+   }
+   void prepWrite(const u8* source, u64 size, u64 offset, void* data) override
+   {
+      ensure(prepared.size() + in_flight.size() < max_requests);
+      prepared.push_back({const_cast<u8*>(source), size, offset, data, true, 0, 0});
+   }
+   u64 submit() override
+   {
+      for (auto& request : prepared) {
+         request.completion_ns = device.schedule(request.size, request.is_write);
+         request.result = request.is_write ? device.writeNow(request.buffer, request.size, request.offset)
+                                           : device.readNow(request.buffer, request.size, request.offset);
+         in_flight.push_back(request);
+      }
+      const u64 submitted = prepared.size();
+      prepared.clear();
+      return submitted;
+   }
+   u64 poll(u64 min_events, u64 max_events, IOEvent* events) override
+   {
+      ensure(min_events <= in_flight.size());
+      std::sort(in_flight.begin(), in_flight.end(), [](const Request& a, const Request& b) { return a.completion_ns > b.completion_ns; });
+      if (min_events > 0) {
+         EmulatedDevice::waitUntil(in_flight[in_flight.size() - min_events].completion_ns);
+      }
+      const u64 now = EmulatedDevice::nowNS();
+      u64 done = 0;
+      while (done < max_events && !in_flight.empty() && in_flight.back().completion_ns <= now) {
+         events[done++] = {in_flight.back().data, in_flight.back().result};
+         in_flight.pop_back();
+      }
+      return done;
+   }
+};
+// -------------------------------------------------------------------------------------
+EmulatedDevice::EmulatedDevice(std::unique_ptr<StorageDevice> backing) : backing(std::move(backing))
+{
+   channels_free_ns.resize(std::max<u64>(FLAGS_ssd_emu_queue_depth, 1), 0);
+   channel_ns_per_byte = (FLAGS_ssd_emu_mib_s == 0) ? 0 : 1e9 * channels_free_ns.size() / (FLAGS_ssd_emu_mib_s * 1024.0 * 1024.0);
+}
+// Anonymous memory, the pages are only backed once written
+EmulatedDevice::EmulatedDevice(u64 dram_size) : EmulatedDevice(std::unique_ptr<StorageDevice>())
+{
+   this->dram_size = dram_size;
+   dram = reinterpret_cast<u8*>(mmap(NULL, dram_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+   if (dram == MAP_FAILED) {
+      SetupFailed("Could not map the DRAM of the emulated SSD");
+   }
+}
+EmulatedDevice::~EmulatedDevice()
+{
+   if (dram) {
+      munmap(dram, dram_size);
+   }
+}
+// -------------------------------------------------------------------------------------
+u64 EmulatedDevice::nowNS()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+// Sleeping overshoots by tens of microseconds, the last stretch is spun
+void EmulatedDevice::waitUntil(u64 deadline_ns)
+{
+   constexpr u64 spin_ns = 100 * 1000;
+   u64 now = nowNS();
+   if (now + spin_ns < deadline_ns) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(deadline_ns - now - spin_ns));
+   }
+   while (nowNS() < deadline_ns) {
+   }
+}
+u64 EmulatedDevice::schedule(u64 size, bool is_write)
+{
+   const u64 service_ns = (is_write ? FLAGS_ssd_emu_write_us : FLAGS_ssd_emu_read_us) * 1000ull + u64(size * channel_ns_per_byte);
+   const u64 now = nowNS();
+   std::unique_lock<std::mutex> guard(channels_mutex);
+   auto channel = std::min_element(channels_free_ns.begin(), channels_free_ns.end());
+   *channel = std::max<u64>(*channel, now) + service_ns;
+   return *channel;
+}
+// -------------------------------------------------------------------------------------
+s64 EmulatedDevice::readNow(u8* destination, u64 size, u64 offset)
+{
+   if (backing) {
+      return backing->read(destination, size, offset);
+   }
+   ensure(offset + size <= dram_size);
+   std::memcpy(destination, dram + offset, size);
+   return size;
+}
+s64 EmulatedDevice::writeNow(const u8* source, u64 size, u64 offset)
+{
+   if (backing) {
+      return backing->write(source, size, offset);
+   }
+   ensure(offset + size <= dram_size);
+   std::memcpy(dram + offset, source, size);
+   return size;
+}
+// -------------------------------------------------------------------------------------
+s64 EmulatedDevice::read(u8* destination, u64 size, u64 offset)
+{
+   const u64 completion_ns = schedule(size, false);
+   const s64 ret = readNow(destination, size, offset);
+   waitUntil(completion_ns);
+   return ret;
+}
+// One request, like preadv on a real device
+s64 EmulatedDevice::readv(const struct iovec* iov, s32 iovcnt, u64 offset)
+{
+   u64 size = 0;
+   for (s32 i = 0; i < iovcnt; i++) {
+      size += iov[i].iov_len;
+   }
+   const u64 completion_ns = schedule(size, false);
+   s64 ret = 0;
+   for (s32 i = 0; i < iovcnt; i++) {
+      const s64 bytes_read = readNow(reinterpret_cast<u8*>(iov[i].iov_base), iov[i].iov_len, offset + ret);
+      if (bytes_read < 0) {
+         return bytes_read;
+      }
+      ret += bytes_read;
+      if (u64(bytes_read) < iov[i].iov_len) {
+         break;
+      }
+   }
+   waitUntil(completion_ns);
+   return ret;
+}
+s64 EmulatedDevice::write(const u8* source, u64 size, u64 offset)
+{
+   const u64 completion_ns = schedule(size, true);
+   const s64 ret = writeNow(source, size, offset);
+   waitUntil(completion_ns);
+   return ret;
+}
+void EmulatedDevice::sync()
+{
+   u64 drained_ns;
+   {
+      std::unique_lock<std::mutex> guard(channels_mutex);
+      drained_ns = *std::max_element(channels_free_ns.begin(), channels_free_ns.end());
+   }
+   if (backing) {
+      backing->sync();
+   }
+   waitUntil(std::max<u64>(drained_ns, nowNS()) + FLAGS_ssd_emu_fsync_us * 1000ull);
+}
+// -------------------------------------------------------------------------------------
+bool EmulatedDevice::allocate(u64 offset, u64 length)
+{
+   return backing ? backing->allocate(offset, length) : offset + length <= dram_size;
+}
+bool EmulatedDevice::discard(u64 offset, u64 length)
+{
+   if (backing) {
+      return backing->discard(offset, length);
+   }
+   ensure(offset + length <= dram_size);
+   return madvise(dram + offset, length, MADV_DONTNEED) == 0;
+}
+u64 EmulatedDevice::capacity()
+{
+   return backing ? backing->capacity() : dram_size;
+}
+std::unique_ptr<AsyncIO> EmulatedDevice::createAsyncIO(u64 max_requests)
+{
+   return std::make_unique<EmulatedAsyncIO>(*this, max_requests);
+}
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,56 @@
+#pragma once
+#include "StorageDevice.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <mutex>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+// Reproduces the timing of an SSD on any machine, to benchmark eviction and group commit changes in CI or on dev boxes.
+// The device serves FLAGS_ssd_emu_queue_depth requests in parallel, each one occupies its channel for the read/write latency
+// plus its transfer time at the channel's share of FLAGS_ssd_emu_mib_s: a queue depth of 1 gets 1/queue_depth of the bandwidth,
+// requests beyond the queue depth wait for a free channel. sync waits for the busiest channel and adds FLAGS_ssd_emu_fsync_us.
+// The data lives in the wrapped device (the data is moved right away, the completion is delayed) or in DRAM
+class EmulatedDevice : public StorageDevice
+{
+  private:
+   friend class EmulatedAsyncIO;
+   std::unique_ptr<StorageDevice> backing;  // nullptr: DRAM
+   u8* dram = nullptr;
+   u64 dram_size = 0;
+   // -------------------------------------------------------------------------------------
+   std::mutex channels_mutex;
+   std::vector<u64> channels_free_ns;  // when each channel finished its last request
+   double channel_ns_per_byte;
+   // -------------------------------------------------------------------------------------
+   s64 readNow(u8* destination, u64 size, u64 offset);
+   s64 writeNow(const u8* source, u64 size, u64 offset);
+
+  public:
+   EmulatedDevice(std::unique_ptr<StorageDevice> backing);
+   EmulatedDevice(u64 dram_size);
+   ~EmulatedDevice() override;
+   // Reserves a channel for a request arriving now, returns its completion time
+   u64 schedule(u64 size, bool is_write);
+   static u64 nowNS();
+   static void waitUntil(u64 deadline_ns);
+   // -------------------------------------------------------------------------------------
+   s64 read(u8* destination, u64 size, u64 offset) override;
+   s64 readv(const struct iovec* iov, s32 iovcnt, u64 offset) override;
+   s64 write(const u8* source, u64 size, u64 offset) override;
+   void sync() override;
+   bool allocate(u64 offset, u64 length) override;
+   bool discard(u64 offset, u64 length) override;
+   u64 capacity() override;
+   std::unique_ptr<AsyncIO> createAsyncIO(u64 max_requests) override;
+};
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,287 @@
+#include "OverlayDevice.hpp"
+
+#include "Exceptions.hpp"
+#include "PosixDevice.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+// Requests entirely within the image or the delta are passed to the AsyncIO of that device,
+// the rare ones straddling both are served synchronously at prep and returned by the next poll
+class OverlayAsyncIO : public AsyncIO
+{
+  private:
+   OverlayDevice& device;
+   std::unique_ptr<AsyncIO> base_aio, delta_aio;
+   u64 base_prepared = 0, delta_prepared = 0, ready_prepared = 0;
+   u64 base_in_flight = 0, delta_in_flight = 0;
+   std::vector<IOEvent> ready;
+
+  public:
+   OverlayAsyncIO(OverlayDevice& device, u64 max_requests)
+       : device(device), base_aio(device.base->createAsyncIO(max_requests)), delta_aio(device.delta->createAsyncIO(max_requests))
+   {
+      ready.reserve(max_requests);
+   }
+   void prepRead(u8* destination, u64 size, u64 offset, void* data) override
+   {
+      if (device.inDelta(offset, size)) {
+         delta_aio->prepRead(destination, size, offset, data);
+         delta_prepared++;
+      } else if (device.inBase(offset, size)) {
+         base_aio->prepRead(destination, size, offset, data);
+         base_prepared++;
+      } else {
+         ready.push_back({data, device.read(destination, size, offset)});
+         ready_prepared++;
+      }
+   }
+   void prepWrite(const u8* source, u64 size, u64 offset, void* data) override
+   {
+      device.prepareWrite(offset, size);
+      delta_aio->prepWrite(source, size, offset, data);
+      delta_prepared++;
+   }
+   u64 submit() override
+   {
+      u64 submitted = ready_prepared;
+      if (base_prepared) {
+         submitted += base_aio->submit();
+         base_in_flight += base_prepared;
+      }
+      if (delta_prepared) {
+         submitted += delta_aio->submit();
+         delta_in_flight += delta_prepared;
+      }
+      base_prepared = delta_prepared = ready_prepared = 0;
+      return submitted;
+   }
+   u64 poll(u64 min_events, u64 max_events, IOEvent* events) override
+   {
+      u64 done = 0;
+      while (done < max_events && !ready.empty()) {
+         events[done++] = ready.back();
+         ready.pop_back();
+      }
+      while (true) {
+         if (done < max_events && base_in_flight) {
+            const u64 polled = base_aio->poll(0, std::min(max_events - done, base_in_flight), events + done);
+            base_in_flight -= polled;
+            done += polled;
+         }
+         if (done < max_events && delta_in_flight) {
+            const u64 polled = delta_aio->poll(0, std::min(max_events - done, delta_in_flight), events + done);
+            delta_in_flight -= polled;
+            done += polled;
+         }
+         if (done >= min_events) {
+            return done;
+         }
+         // Block on one of them, the other one is checked again right after
+         if (delta_in_flight) {
+            const u64 polled = delta_aio->poll(1, std::min(max_events - done, delta_in_flight), events + done);
+            delta_in_flight -= polled;
+            done += polled;
+         } else {
+            ensure(base_in_flight);
+            const u64 polled = base_aio->poll(1, std::min(max_events - done, base_in_flight), events + done);
+            base_in_flight -= polled;
+            done += polled;
+         }
+      }
+   }
+};
+// -------------------------------------------------------------------------------------
+OverlayDevice::OverlayDevice(std::unique_ptr<StorageDevice> base, std::unique_ptr<StorageDevice> delta)
+    : base(std::move(base)), delta(std::move(delta)), base_size(this->base->capacity())
+{
+   const u64 words = (base_size / COW_BLOCK_SIZE + 1) / 64 + 1;
+   written = std::make_unique<std::atomic<u64>[]>(words);
+   for (u64 w_i = 0; w_i < words; w_i++) {
+      written[w_i] = 0;
+   }
+}
+// -------------------------------------------------------------------------------------
+bool OverlayDevice::inDelta(u64 offset, u64 size)
+{
+   for (u64 block = offset / COW_BLOCK_SIZE; block * COW_BLOCK_SIZE < offset + size; block++) {
+      if (!isWritten(block)) {
+         return false;
+      }
+   }
+   return true;
+}
+bool OverlayDevice::inBase(u64 offset, u64 size)
+{
+   for (u64 block = offset / COW_BLOCK_SIZE; block * COW_BLOCK_SIZE < offset + size; block++) {
+      if (isWritten(block)) {
+         return false;
+      }
+   }
+   return true;
+}
+// -------------------------------------------------------------------------------------
+// The blocks are marked before the delta write completes, the buffer manager never reads a page while writing it
+void OverlayDevice::prepareWrite(u64 offset, u64 size)
+{
+   const u64 first_block = offset / COW_BLOCK_SIZE, last_block = (offset + size - 1) / COW_BLOCK_SIZE;
+   for (u64 block : {first_block, last_block}) {
+      const bool partial = (block == first_block && offset % COW_BLOCK_SIZE) || (block == last_block && (offset + size) % COW_BLOCK_SIZE);
+      if (!partial || isWritten(block)) {
+         continue;
+      }
+      std::unique_lock<std::mutex> guard(copy_up_mutex);
+      if (isWritten(block)) {
+         continue;
+      }
+      auto buffer = reinterpret_cast<u8*>(aligned_alloc(COW_BLOCK_SIZE, COW_BLOCK_SIZE));
+      const s64 bytes_read = base->read(buffer, COW_BLOCK_SIZE, block * COW_BLOCK_SIZE);
+      posix_check(bytes_read >= 0);
+      std::memset(buffer + bytes_read, 0, COW_BLOCK_SIZE - bytes_read);
+      posix_check(delta->write(buffer, COW_BLOCK_SIZE, block * COW_BLOCK_SIZE) == s64(COW_BLOCK_SIZE));
+      free(buffer);
+      written[block / 64] |= (1ull << (block % 64));
+   }
+   for (u64 block = first_block; block <= last_block && block * COW_BLOCK_SIZE < base_size; block++) {
+      written[block / 64] |= (1ull << (block % 64));
+   }
+}
+// -------------------------------------------------------------------------------------
+// Splits the range into runs of blocks that live on the same device
+s64 OverlayDevice::read(u8* destination, u64 size, u64 offset)
+{
+   u64 done = 0;
+   while (done < size) {
+      const u64 run_begin = offset + done;
+      const bool from_delta = isWritten(run_begin / COW_BLOCK_SIZE);
+      u64 run_end = std::min((run_begin / COW_BLOCK_SIZE + 1) * COW_BLOCK_SIZE, offset + size);
+      while (run_end < offset + size && isWritten(run_end / COW_BLOCK_SIZE) == from_delta) {
+         run_end = std::min(run_end + COW_BLOCK_SIZE, offset + size);
+      }
+      const s64 bytes_read = (from_delta ? delta : base)->read(destination + done, run_end - run_begin, run_begin);
+      if (bytes_read < 0) {
+         return bytes_read;
+      }
+      done += bytes_read;
+      if (u64(bytes_read) < run_end - run_begin) {
+         break;
+      }
+   }
+   return done;
+}
+s64 OverlayDevice::readv(const struct iovec* iov, s32 iovcnt, u64 offset)
+{
+   u64 size = 0;
+   for (s32 i = 0; i < iovcnt; i++) {
+      size += iov[i].iov_len;
+   }
+   if (inDelta(offset, size)) {
+      return delta->readv(iov, iovcnt, offset);
+   } else if (inBase(offset, size)) {
+      return base->readv(iov, iovcnt, offset);
+   }
+   s64 ret = 0;
+   for (s32 i = 0; i < iovcnt; i++) {
+      const s64 bytes_read = read(reinterpret_cast<u8*>(iov[i].iov_base), iov[i].iov_len, offset + ret);
+      if (bytes_read < 0) {
+         return bytes_read;
+      }
+      ret += bytes_read;
+      if (u64(bytes_read) < iov[i].iov_len) {
+         break;
+      }
+   }
+   return ret;
+}
+s64 OverlayDevice::write(const u8* source, u64 size, u64 offset)
+{
+   prepareWrite(offset, size);
+   return delta->write(source, size, offset);
+}
+void OverlayDevice::sync()
+{
+   delta->sync();
+}
+// -------------------------------------------------------------------------------------
+bool OverlayDevice::allocate(u64 offset, u64 length)
+{
+   return delta->allocate(offset, length);
+}
+// The image keeps its blocks, only the copies in the delta are released
+bool OverlayDevice::discard(u64 offset, u64 length)
+{
+   return delta->discard(offset, length);
+}
+u64 OverlayDevice::capacity()
+{
+   return std::max(base_size, delta->capacity());
+}
+std::unique_ptr<AsyncIO> OverlayDevice::createAsyncIO(u64 max_requests)
+{
+   return std::make_unique<OverlayAsyncIO>(*this, max_requests);
+}
+// -------------------------------------------------------------------------------------
+bool sameFile(const std::string& path_a, const std::string& path_b)
+{
+   struct stat st_a, st_b;
+   if (stat(path_a.c_str(), &st_a) != 0 || stat(path_b.c_str(), &st_b) != 0) {
+      return false;
+   }
+   return st_a.st_dev == st_b.st_dev && st_a.st_ino == st_b.st_ino;
+}
+// -------------------------------------------------------------------------------------
+std::unique_ptr<StorageDevice> openClone(const std::string& base_path, const std::string& clone_path, const std::string& mode, bool& is_overlay)
+{
+   if (mode != "reflink" && mode != "overlay" && mode != "auto") {
+      SetupFailed("Unknown clone mode " + mode);
+   }
+   // Opening the clone truncates it, root ignores the permissions of a frozen image
+   if (sameFile(base_path, clone_path)) {
+      SetupFailed("The clone " + clone_path + " is the SSD of its image, choose another ssd_path");
+   }
+   const s32 base_fd = open(base_path.c_str(), O_RDONLY | O_DIRECT);
+   if (base_fd == -1) {
+      perror("posix error");
+      std::cout << "path: " << base_path << std::endl;
+      SetupFailed("Could not open the SSD of the image to clone");
+   }
+   const s32 clone_fd = open(clone_path.c_str(), O_RDWR | O_DIRECT | O_CREAT | O_TRUNC, 0666);
+   if (clone_fd == -1) {
+      perror("posix error");
+      std::cout << "path: " << clone_path << std::endl;
+      SetupFailed("Could not create the SSD of the clone");
+   }
+   if (mode != "overlay") {
+      if (ioctl(clone_fd, FICLONE, base_fd) == 0) {
+         close(base_fd);
+         is_overlay = false;
+         return std::make_unique<PosixDevice>(clone_fd);
+      }
+      if (mode == "reflink") {
+         perror("posix error");
+         SetupFailed("Could not reflink " + base_path + " to " + clone_path);
+      }
+   }
+   is_overlay = true;
+   return std::make_unique<OverlayDevice>(std::make_unique<PosixDevice>(base_fd), std::make_unique<PosixDevice>(clone_fd));
+}
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
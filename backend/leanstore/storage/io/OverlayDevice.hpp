@@ -0,0 +1,56 @@
+#pragma once
+#include "StorageDevice.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <mutex>
+#include <string>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+// Copy-on-write view of a read-only image: writes go to a sparse delta file at the same offsets, reads go to the delta for the
+// blocks written since the clone was opened and to the image otherwise. The written blocks are tracked in a bitmap over the image,
+// everything past the end of the image lives in the delta. Writes that partially cover a block copy the block up first
+class OverlayDevice : public StorageDevice
+{
+  private:
+   friend class OverlayAsyncIO;
+   static constexpr u64 COW_BLOCK_SIZE = 4096;
+   std::unique_ptr<StorageDevice> base, delta;
+   const u64 base_size;
+   std::unique_ptr<std::atomic<u64>[]> written;  // one bit per block of the image
+   std::mutex copy_up_mutex;
+   // -------------------------------------------------------------------------------------
+   bool isWritten(u64 block) { return block * COW_BLOCK_SIZE >= base_size || (written[block / 64].load() >> (block % 64)) & 1; }
+   bool inDelta(u64 offset, u64 size);
+   bool inBase(u64 offset, u64 size);
+   // Copies up the partially covered blocks at both ends, then marks the whole range as written
+   void prepareWrite(u64 offset, u64 size);
+
+  public:
+   OverlayDevice(std::unique_ptr<StorageDevice> base, std::unique_ptr<StorageDevice> delta);
+   s64 read(u8* destination, u64 size, u64 offset) override;
+   s64 readv(const struct iovec* iov, s32 iovcnt, u64 offset) override;
+   s64 write(const u8* source, u64 size, u64 offset) override;
+   void sync() override;
+   bool allocate(u64 offset, u64 length) override;
+   bool discard(u64 offset, u64 length) override;
+   u64 capacity() override;
+   std::unique_ptr<AsyncIO> createAsyncIO(u64 max_requests) override;
+};
+// -------------------------------------------------------------------------------------
+// True when both paths exist and name the same file (device and inode), whatever the paths look like
+bool sameFile(const std::string& path_a, const std::string& path_b);
+// Opens clone_path as a copy-on-write clone of the SSD file at base_path, which is only read.
+// mode "reflink" shares the extents of the image (btrfs, XFS), "overlay" puts an OverlayDevice with clone_path as delta over the image,
+// "auto" tries reflink first. is_overlay tells which one it became. Fails when clone_path is the image itself
+std::unique_ptr<StorageDevice> openClone(const std::string& base_path, const std::string& clone_path, const std::string& mode, bool& is_overlay);
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
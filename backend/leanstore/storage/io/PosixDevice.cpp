@@ -0,0 +1,146 @@
+#include "PosixDevice.hpp"
+
+#include "Exceptions.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <libaio.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+namespace
+{
+class PosixAsyncIO : public AsyncIO
+{
+  private:
+   const s32 fd;
+   const u64 max_requests;
+   io_context_t aio_context;
+   std::unique_ptr<struct iocb[]> iocbs;
+   std::unique_ptr<struct iocb*[]> iocbs_ptr;
+   std::unique_ptr<struct io_event[]> events;
+   u64 prepared = 0;
+   // -------------------------------------------------------------------------------------
+   // io_prep_* clears the iocb, data is set afterwards
+   struct iocb& nextIOCB()
+   {
+      ensure(prepared < max_requests);
+      iocbs_ptr[prepared] = &iocbs[prepared];
+      return iocbs[prepared++];
+   }
+
+  public:
+   PosixAsyncIO(s32 fd, u64 max_requests) : fd(fd), max_requests(max_requests)
+   {
+      iocbs = std::make_unique<struct iocb[]>(max_requests);
+      iocbs_ptr = std::make_unique<struct iocb*[]>(max_requests);
+      events = std::make_unique<struct io_event[]>(max_requests);
+      memset(&aio_context, 0, sizeof(aio_context));
+      const int ret = io_setup(max_requests, &aio_context);
+      if (ret != 0) {
+         throw ex::GenericException("io_setup failed, ret code = " + std::to_string(ret));
+      }
+   }
+   ~PosixAsyncIO() override { io_destroy(aio_context); }
+   void prepRead(u8* destination, u64 size, u64 offset, void* data) override
+   {
+      struct iocb& cb = nextIOCB();
+      io_prep_pread(&cb, fd, destination, size, offset);
+      cb.data = data;
+   }
+   void prepWrite(const u8* source, u64 size, u64 offset, void* data) override
+   {
+      struct iocb& cb = nextIOCB();
+      io_prep_pwrite(&cb, fd, const_cast<u8*>(source), size, offset);
+      cb.data = data;
+   }
+   u64 submit() override
+   {
+      u64 submitted = 0;
+      while (submitted < prepared) {
+         const int ret_code = io_submit(aio_context, prepared - submitted, iocbs_ptr.get() + submitted);
+         ensure(ret_code > 0);
+         submitted += ret_code;
+      }
+      prepared = 0;
+      return submitted;
+   }
+   u64 poll(u64 min_events, u64 max_events, IOEvent* out) override
+   {
+      ensure(max_events <= max_requests);
+      const int done = io_getevents(aio_context, min_events, max_events, events.get(), NULL);
+      ensure(done >= s32(min_events));
+      for (int e_i = 0; e_i < done; e_i++) {
+         out[e_i].data = events[e_i].data;
+         out[e_i].result = (events[e_i].res2 == 0) ? s64(events[e_i].res) : -s64(events[e_i].res2);
+      }
+      return done;
+   }
+};
+}  // namespace
+// -------------------------------------------------------------------------------------
+PosixDevice::PosixDevice(s32 fd) : fd(fd) {}
+PosixDevice::~PosixDevice()
+{
+   close(fd);
+}
+// -------------------------------------------------------------------------------------
+s64 PosixDevice::read(u8* destination, u64 size, u64 offset)
+{
+   return pread(fd, destination, size, offset);
+}
+s64 PosixDevice::readv(const struct iovec* iov, s32 iovcnt, u64 offset)
+{
+   return preadv(fd, iov, iovcnt, offset);
+}
+s64 PosixDevice::write(const u8* source, u64 size, u64 offset)
+{
+   return pwrite(fd, source, size, offset);
+}
+void PosixDevice::sync()
+{
+   fdatasync(fd);
+}
+// -------------------------------------------------------------------------------------
+bool PosixDevice::allocate(u64 offset, u64 length)
+{
+   return fallocate(fd, 0, offset, length) == 0;
+}
+// Files get their holes punched, block devices are discarded
+bool PosixDevice::discard(u64 offset, u64 length)
+{
+   if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, length) == 0) {
+      return true;
+   }
+   u64 range[2] = {offset, length};
+   return ioctl(fd, BLKDISCARD, &range) == 0;
+}
+u64 PosixDevice::capacity()
+{
+   u64 size = 0;
+   if (ioctl(fd, BLKGETSIZE64, &size) != 0) {
+      struct stat st;
+      size = (fstat(fd, &st) == 0) ? st.st_size : 0;
+   }
+   return size;
+}
+// -------------------------------------------------------------------------------------
+std::unique_ptr<AsyncIO> PosixDevice::createAsyncIO(u64 max_requests)
+{
+   return std::make_unique<PosixAsyncIO>(fd, max_requests);
+}
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
@@ -0,0 +1,34 @@
+#pragma once
+#include "StorageDevice.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+// A file or block device opened with O_DIRECT, asynchronous requests go through libaio
+class PosixDevice : public StorageDevice
+{
+  private:
+   const s32 fd;
+
+  public:
+   // Takes the ownership of fd
+   PosixDevice(s32 fd);
+   ~PosixDevice() override;
+   s64 read(u8* destination, u64 size, u64 offset) override;
+   s64 readv(const struct iovec* iov, s32 iovcnt, u64 offset) override;
+   s64 write(const u8* source, u64 size, u64 offset) override;
+   void sync() override;
+   bool allocate(u64 offset, u64 length) override;
+   bool discard(u64 offset, u64 length) override;
+   u64 capacity() override;
+   std::unique_ptr<AsyncIO> createAsyncIO(u64 max_requests) override;
+};
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
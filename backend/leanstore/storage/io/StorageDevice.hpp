@@ -0,0 +1,56 @@
+#pragma once
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <sys/uio.h>
+
+#include <memory>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace storage
+{
+namespace io
+{
+// -------------------------------------------------------------------------------------
+struct IOEvent {
+   void* data;  // as passed to prepRead/prepWrite
+   s64 result;  // bytes transferred, negative errno on failure
+};
+// -------------------------------------------------------------------------------------
+// A batch of asynchronous requests to one device, used by one thread at a time
+// The caller prepares up to max_requests requests, submits them, then polls until all completed
+class AsyncIO
+{
+  public:
+   virtual ~AsyncIO() = default;
+   virtual void prepRead(u8* destination, u64 size, u64 offset, void* data) = 0;
+   virtual void prepWrite(const u8* source, u64 size, u64 offset, void* data) = 0;
+   // Returns the number of submitted requests
+   virtual u64 submit() = 0;
+   // Blocks until at least min_events of the submitted requests completed, returns up to max_events of them
+   virtual u64 poll(u64 min_events, u64 max_events, IOEvent* events) = 0;
+};
+// -------------------------------------------------------------------------------------
+// Everything the buffer manager and the group committers do with an SSD goes through this interface.
+// PosixDevice is the O_DIRECT file or block device, EmulatedDevice injects a configurable latency and bandwidth
+class StorageDevice
+{
+  public:
+   virtual ~StorageDevice() = default;
+   // pread/pwrite semantics
+   virtual s64 read(u8* destination, u64 size, u64 offset) = 0;
+   virtual s64 readv(const struct iovec* iov, s32 iovcnt, u64 offset) = 0;
+   virtual s64 write(const u8* source, u64 size, u64 offset) = 0;
+   virtual void sync() = 0;
+   // Reserves the range, false when the device can not (e.g., a block device)
+   virtual bool allocate(u64 offset, u64 length) = 0;
+   // Releases the range, later reads return zeros or garbage
+   virtual bool discard(u64 offset, u64 length) = 0;
+   virtual u64 capacity() = 0;
+   virtual std::unique_ptr<AsyncIO> createAsyncIO(u64 max_requests) = 0;
+};
+// -------------------------------------------------------------------------------------
+}  // namespace io
+}  // namespace storage
+}  // namespace leanstore
@@ -57,6 +57,7 @@ class HybridPageGuard
    {
       assert(BMC::global_bf != nullptr);
       bf->page.dt_id = dt_id;
+      BMC::global_bf->getDTRegistry().residentPageAdded(dt_id);
       markAsDirty();
       jumpmu_registerDestructor();
    }
@@ -147,6 +148,7 @@ class HybridPageGuard
    {
       assert(FLAGS_wal);
       assert(guard.state == GUARD_STATE::EXCLUSIVE);
+      PROFILE_REGION(RegionCounters::WAL_APPEND);
       if (!FLAGS_wal_tuple_rfa) {
          incrementGSN();
       }
@@ -0,0 +1,129 @@
+#pragma once
+#include "Exceptions.hpp"
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------
+#include <atomic>
+#include <cassert>
+#include <memory>
+// -------------------------------------------------------------------------------------
+namespace leanstore
+{
+namespace utils
+{
+// -------------------------------------------------------------------------------------
+// Single-producer single-consumer ring buffer without any mutex
+// The consumer works in batches: snapshot size(), read the first n entries with at(i), then popFront(n)
+// Entries stay owned by the consumer until they are popped, so it can modify them in place
+// The consumer may hold entries back for an unbounded time (e.g., RFA waits for the GSN of all workers), so push never waits:
+// when the ring is full, the producer links a segment of twice the capacity and continues there.
+// The consumer moves on once it drained the full segment, a batch hence never spans two segments
+template <typename T>
+class RingBufferSPSC
+{
+  private:
+   struct Segment {
+      const u64 capacity;
+      const u64 mask;
+      std::unique_ptr<T[]> slots;
+      // -------------------------------------------------------------------------------------
+      alignas(64) std::atomic<u64> head = 0;  // W: consumer, R: producer
+      u64 cached_tail = 0;                    // consumer-local copy of tail
+      alignas(64) std::atomic<u64> tail = 0;  // W: producer, R: consumer
+      u64 cached_head = 0;                    // producer-local copy of head
+      std::atomic<Segment*> next = nullptr;   // W: producer once the segment is full, R: consumer
+      // -------------------------------------------------------------------------------------
+      Segment(u64 capacity) : capacity(capacity), mask(capacity - 1) { slots = std::make_unique<T[]>(capacity); }
+      inline bool tryPush(const T& entry)
+      {
+         const u64 current_tail = tail.load(std::memory_order_relaxed);
+         if (current_tail - cached_head == capacity) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (current_tail - cached_head == capacity) {
+               return false;
+            }
+         }
+         slots[current_tail & mask] = entry;
+         tail.store(current_tail + 1, std::memory_order_release);
+         return true;
+      }
+      inline u64 size()
+      {
+         cached_tail = tail.load(std::memory_order_acquire);
+         return cached_tail - head.load(std::memory_order_relaxed);
+      }
+   };
+   Segment* producer_segment;  // W: producer
+   Segment* consumer_segment;  // W: consumer, which also frees the drained segments
+   // -------------------------------------------------------------------------------------
+   static u64 roundUpToPowerOfTwo(u64 n)
+   {
+      u64 power = 1;
+      while (power < n) {
+         power <<= 1;
+      }
+      return power;
+   }
+
+  public:
+   RingBufferSPSC(u64 min_capacity)
+   {
+      ensure(min_capacity > 0);
+      producer_segment = consumer_segment = new Segment(roundUpToPowerOfTwo(min_capacity));
+   }
+   ~RingBufferSPSC()
+   {
+      while (consumer_segment) {
+         Segment* next = consumer_segment->next.load();
+         delete consumer_segment;
+         consumer_segment = next;
+      }
+   }
+   RingBufferSPSC(const RingBufferSPSC&) = delete;
+   RingBufferSPSC& operator=(const RingBufferSPSC&) = delete;
+   // -------------------------------------------------------------------------------------
+   // Producer
+   // Fails when the current segment is full
+   inline bool tryPush(const T& entry) { return producer_segment->tryPush(entry); }
+   // Grows instead of waiting for the consumer
+   inline void push(const T& entry)
+   {
+      if (!producer_segment->tryPush(entry)) {
+         Segment* segment = new Segment(producer_segment->capacity * 2);
+         segment->tryPush(entry);
+         producer_segment->next.store(segment, std::memory_order_release);
+         producer_segment = segment;
+      }
+   }
+   // -------------------------------------------------------------------------------------
+   // Consumer
+   inline u64 size()
+   {
+      u64 n = consumer_segment->size();
+      while (n == 0) {
+         Segment* next = consumer_segment->next.load(std::memory_order_acquire);
+         if (next == nullptr) {
+            break;
+         }
+         // The producer filled the segment before it linked the next one, recheck for the entries pushed meanwhile
+         n = consumer_segment->size();
+         if (n == 0) {
+            delete consumer_segment;
+            consumer_segment = next;
+            n = consumer_segment->size();
+         }
+      }
+      return n;
+   }
+   inline bool empty() { return size() == 0; }
+   // Pre: i < size()
+   inline T& at(u64 i) { return consumer_segment->slots[(consumer_segment->head.load(std::memory_order_relaxed) + i) & consumer_segment->mask]; }
+   inline void popFront(u64 n)
+   {
+      assert(consumer_segment->head.load(std::memory_order_relaxed) + n <= consumer_segment->cached_tail);
+      consumer_segment->head.store(consumer_segment->head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+   }
+};
+// -------------------------------------------------------------------------------------
+}  // namespace utils
+}  // namespace leanstore
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <functional>
 #include <string>
+#include <vector>
 // -------------------------------------------------------------------------------------
 // Helpers to generate a descriptor that describes which attributes are in-place updating in a fixed-size value
 #define UpdateDescriptorInit(Name, Count)                                                                                                     \
@@ -69,6 +70,9 @@ class Adapter
    // Returns false if the record was not found
    virtual bool erase(const typename Record::Key& key) = 0;
    // -------------------------------------------------------------------------------------
+   // Hint: the keys are accessed soon, engines without prefetching ignore it
+   virtual void prefetch(const std::vector<typename Record::Key>&) {}
+   // -------------------------------------------------------------------------------------
    template <class Field>
    Field lookupField(const typename Record::Key& key, Field Record::*f)
    {
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <functional>
 #include <string>
+#include <vector>
 
 using namespace leanstore;
 template <class Record>
@@ -86,6 +87,22 @@ struct LeanStoreAdapter : Adapter<Record> {
       ensure(res == leanstore::OP_RESULT::OK);
    }
    // -------------------------------------------------------------------------------------
+   void prefetch(const std::vector<typename Record::Key>& keys) final
+   {
+      if (!FLAGS_prefetch) {
+         return;
+      }
+      std::vector<u8> folded_keys(keys.size() * Record::maxFoldLength());
+      std::vector<leanstore::Slice> slices;
+      slices.reserve(keys.size());
+      for (u64 k_i = 0; k_i < keys.size(); k_i++) {
+         u8* folded_key = folded_keys.data() + k_i * Record::maxFoldLength();
+         const u16 folded_key_len = Record::foldKey(folded_key, keys[k_i]);
+         slices.emplace_back(folded_key, folded_key_len);
+      }
+      btree->prefetch(slices);
+   }
+   // -------------------------------------------------------------------------------------
    void update1(const typename Record::Key& key, const std::function<void(Record&)>& cb, UpdateSameSizeInPlaceDescriptor& update_descriptor) final
    {
       u8 folded_key[Record::maxFoldLength()];
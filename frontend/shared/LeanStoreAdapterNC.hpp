@@ -26,8 +26,8 @@ struct LeanStoreAdapter : Adapter<Record> {
    }
    LeanStoreAdapter(LeanStore& db, string name) : name(name)
    {
-      key_tid = &db.registerBTreeLL(name + "_key_tid", false);
-      tid_value = &db.registerBTreeLL(name + "_tid_value", false);
+      key_tid = &db.registerBTreeLL(name + "_key_tid", {.enable_wal = FLAGS_wal, .use_bulk_insert = false});
+      tid_value = &db.registerBTreeLL(name + "_tid_value", {.enable_wal = FLAGS_wal, .use_bulk_insert = false});
    }
    // -------------------------------------------------------------------------------------
    void printTreeHeight() {}
@@ -168,66 +168,50 @@ struct LeanStoreAdapter : Adapter<Record> {
    // -------------------------------------------------------------------------------------
    void scan(const typename Record::Key& key,
              const std::function<bool(const typename Record::Key&, const Record&)>& cb,
-             std::function<void()> undo) final
+             std::function<void()>) final
    {
-      u8 folded_key[Record::maxFoldLength()];
-      u16 folded_key_len = Record::foldKey(folded_key, key);
-      // -------------------------------------------------------------------------------------
-      OP_RESULT ret;
-      ret = key_tid->scanAsc(
-          folded_key, folded_key_len,
-          [&](const u8* key, [[maybe_unused]] u16 key_length, const u8* tid_ptr, [[maybe_unused]] u16 tid_length) {
-             TID tid = *reinterpret_cast<const TID*>(tid_ptr);
-             ensure(tid_length == sizeof(TID));
-             // -------------------------------------------------------------------------------------
-             bool should_continue;
-             OP_RESULT res2 = tid_value->lookup((u8*)&tid, sizeof(TID), [&](const u8* value_ptr, u16 value_length) {
-                ensure(value_length == sizeof(Record));
-                typename Record::Key typed_key;
-                Record::unfoldKey(key, typed_key);
-                const Record& typed_payload = *reinterpret_cast<const Record*>(value_ptr);
-                should_continue = cb(typed_key, typed_payload);
-             });
-             if (res2 == OP_RESULT::OK) {
-                return should_continue;
-             } else {
-                return true;
-             }
-          },
-          undo);
-      ensure(ret == OP_RESULT::OK);
+      scanKeyTID(key, cb, true);
    }
    // -------------------------------------------------------------------------------------
    void scanDesc(const typename Record::Key& key,
                  const std::function<bool(const typename Record::Key&, const Record&)>& cb,
-                 std::function<void()> undo) final
+                 std::function<void()>) final
+   {
+      scanKeyTID(key, cb, false);
+   }
+   // -------------------------------------------------------------------------------------
+   // Walks key_tid with a cursor that is paused for the tid_value lookup and the callback, so no latch of either tree is held meanwhile
+   void scanKeyTID(const typename Record::Key& key, const std::function<bool(const typename Record::Key&, const Record&)>& cb, const bool asc)
    {
       u8 folded_key[Record::maxFoldLength()];
       u16 folded_key_len = Record::foldKey(folded_key, key);
       // -------------------------------------------------------------------------------------
-      OP_RESULT ret;
-      ret = key_tid->scanDesc(
-          folded_key, folded_key_len,
-          [&](const u8* key, [[maybe_unused]] u16 key_length, const u8* tid_ptr, [[maybe_unused]] u16 tid_length) {
-             const TID tid = *reinterpret_cast<const TID*>(tid_ptr);
-             ensure(tid_length == sizeof(TID));
-             // -------------------------------------------------------------------------------------
-             bool should_continue;
-             OP_RESULT res2 = tid_value->lookup((u8*)&tid, sizeof(TID), [&](const u8* value_ptr, u16 value_length) {
-                ensure(value_length == sizeof(Record));
-                typename Record::Key typed_key;
-                Record::unfoldKey(key, typed_key);
-                const Record& typed_payload = *reinterpret_cast<const Record*>(value_ptr);
-                should_continue = cb(typed_key, typed_payload);
-             });
-             if (res2 == OP_RESULT::OK) {
-                return should_continue;
-             } else {
-                return true;
-             }
-          },
-          undo);
-      ensure(ret == OP_RESULT::OK);
+      jumpmuTry()
+      {
+         leanstore::storage::btree::BTreeCursor cursor(*key_tid);
+         const Slice start_key(folded_key, folded_key_len);
+         OP_RESULT ret = asc ? cursor.seek(start_key) : cursor.seekForPrev(start_key);
+         while (ret == OP_RESULT::OK) {
+            ensure(cursor.value().length() == sizeof(TID));
+            const TID tid = *reinterpret_cast<const TID*>(cursor.value().data());
+            typename Record::Key typed_key;
+            Record::unfoldKey(cursor.key().data(), typed_key);
+            cursor.pause();
+            // -------------------------------------------------------------------------------------
+            Record record;
+            OP_RESULT res2 = tid_value->lookup((u8*)&tid, sizeof(TID), [&](const u8* value_ptr, u16 value_length) {
+               ensure(value_length == sizeof(Record));
+               record = *reinterpret_cast<const Record*>(value_ptr);
+            });
+            if (res2 == OP_RESULT::OK && !cb(typed_key, record)) {
+               break;
+            }
+            ret = asc ? cursor.next() : cursor.prev();
+         }
+         jumpmu_return;
+      }
+      jumpmuCatch() {}
+      UNREACHABLE();
    }
    // -------------------------------------------------------------------------------------
    template <class Field>
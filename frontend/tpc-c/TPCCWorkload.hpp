@@ -5,6 +5,7 @@
 #include "leanstore/Config.hpp"
 #include "leanstore/KVInterface.hpp"
 #include "leanstore/concurrency-recovery/Worker.hpp"
+#include "leanstore/profiling/counters/RegionCounters.hpp"
 #include "leanstore/profiling/counters/WorkerCounters.hpp"
 #include "leanstore/storage/btree/core/WALMacros.hpp"
 #include "leanstore/utils/RandomGenerator.hpp"
@@ -40,6 +41,7 @@ class TPCCWorkload
    const Integer tpcc_remove;
    const bool manually_handle_isolation_anomalies;
    const bool warehouse_affinity;
+   u64 tx_regions[5];  // by tx number, for profile_regions
    // -------------------------------------------------------------------------------------
    Integer urandexcept(Integer low, Integer high, Integer v)
    {
@@ -150,6 +152,14 @@ class TPCCWorkload
                  const vector<Integer>& qtys,
                  Timestamp timestamp)
    {
+      // The stock rows are known up front, let their reads overlap with the rest of the transaction
+      vector<stock_t::Key> stock_keys;
+      stock_keys.reserve(lineNumbers.size());
+      for (unsigned i = 0; i < lineNumbers.size(); i++) {
+         stock_keys.push_back({supwares[i], itemids[i]});
+      }
+      stock.prefetch(stock_keys);
+
       Numeric w_tax = warehouse.lookupField({w_id}, &warehouse_t::w_tax);
       Numeric c_discount = customer.lookupField({w_id, d_id, c_id}, &customer_t::c_discount);
       Numeric d_tax;
@@ -848,6 +858,10 @@ class TPCCWorkload
          manually_handle_isolation_anomalies(manually_handle_isolation_anomalies),
          warehouse_affinity(warehouse_affinity)
    {
+      const char* tx_names[5] = {"payment", "order_status", "delivery", "stock_level", "new_order"};
+      for (u64 tx_i = 0; tx_i < 5; tx_i++) {
+         tx_regions[tx_i] = leanstore::RegionCounters::registerRegion(tx_names[tx_i]);
+      }
    }
    // -------------------------------------------------------------------------------------
    // [0, n)
@@ -1012,6 +1026,7 @@ class TPCCWorkload
    // -------------------------------------------------------------------------------------
    void execTX(Integer w_id, s32 tx_number)
    {
+      PROFILE_REGION(tx_regions[tx_number]);
       if (tx_number == 0) {
          paymentRnd(w_id);
       } else if (tx_number == 1) {
@@ -1030,25 +1045,30 @@ class TPCCWorkload
       // micro-optimized version of weighted distribution
       u64 rnd = leanstore::utils::RandomGenerator::getRand(0, 10000);
       if (rnd < 4300) {
+         PROFILE_REGION(tx_regions[0]);
          paymentRnd(w_id);
          return 0;
       }
       rnd -= 4300;
       if (rnd < 400) {
+         PROFILE_REGION(tx_regions[1]);
          orderStatusRnd(w_id);
          return 1;
       }
       rnd -= 400;
       if (rnd < 400) {
+         PROFILE_REGION(tx_regions[2]);
          deliveryRnd(w_id);
          return 2;
       }
       rnd -= 400;
       if (rnd < 400) {
+         PROFILE_REGION(tx_regions[3]);
          stockLevelRnd(w_id);
          return 3;
       }
       rnd -= 400;
+      PROFILE_REGION(tx_regions[4]);
       newOrderRnd(w_id);
       return 4;
    }